@@ -434,6 +434,8 @@ END
  ***************************************************************************/
 void          aux_bib_data_command (void)
 BEGIN
+  HashLoc_T         bib_loc;
+
   if (bib_seen)
   BEGIN
     AUX_ERR_ILLEGAL_ANOTHER (N_AUX_BIBDATA);
@@ -472,8 +474,9 @@ BEGIN
         BIB_XRETALLOC ("s_preamble", s_preamble, StrNumber_T,
                        Max_Bib_Files, Max_Bib_Files + MAX_BIB_FILES);
       END
-      CUR_BIB_STR = hash_text[str_lookup (buffer, buf_ptr1, TOKEN_LEN,
-  					  BIB_FILE_ILK, DO_INSERT)];
+      bib_loc = str_lookup (buffer, buf_ptr1, TOKEN_LEN, BIB_FILE_ILK,
+			    DO_INSERT);
+      CUR_BIB_STR = hash_text[bib_loc];
       if (hash_found)
       BEGIN
         OPEN_BIBDATA_AUX_ERR ("This database file appears more than once: ");
@@ -517,6 +520,8 @@ END
  ***************************************************************************/
 void          aux_bib_style_command (void)
 BEGIN
+  HashLoc_T         bst_loc;
+
   if (bst_seen)
   BEGIN
     AUX_ERR_ILLEGAL_ANOTHER (N_AUX_BIBSTYLE);
@@ -543,8 +548,9 @@ BEGIN
  * with the |s_bst_extension| string, if possible.
  ***************************************************************************/
   BEGIN
-    bst_str = hash_text[str_lookup (buffer, buf_ptr1, TOKEN_LEN,
-				    BST_FILE_ILK, DO_INSERT)];
+    bst_loc = str_lookup (buffer, buf_ptr1, TOKEN_LEN, BST_FILE_ILK,
+			  DO_INSERT);
+    bst_str = hash_text[bst_loc];
     if (hash_found)
     BEGIN
 
@@ -868,6 +874,7 @@ END
 void          aux_input_command (void)
 BEGIN
   Boolean_T         aux_extension_ok;
+  HashLoc_T         aux_loc;
 
   INCR (buf_ptr2);
   if ( ! scan1_white (RIGHT_BRACE))
@@ -916,8 +923,9 @@ BEGIN
       DECR (aux_ptr);
       AUX_ERR_RETURN;
     END
-    CUR_AUX_STR = hash_text[str_lookup (buffer, buf_ptr1, TOKEN_LEN,
-					AUX_FILE_ILK, DO_INSERT)];
+    aux_loc = str_lookup (buffer, buf_ptr1, TOKEN_LEN, AUX_FILE_ILK,
+			  DO_INSERT);
+    CUR_AUX_STR = hash_text[aux_loc];
     if (hash_found)
     BEGIN
       PRINT ("Already encountered file ");
@@ -2072,9 +2080,12 @@ BEGIN
       print_bib_name ();
       bib_line_num = 0;
       buf_ptr2 = last;
-      while ( ! feof (CUR_BIB_FILE))
+      if (( ! Flag_index) || (all_entries) || ( ! read_bib_file_indexed ()))
       BEGIN
-	get_bib_command_or_entry_and_pr ();
+        while ( ! feof (CUR_BIB_FILE))
+        BEGIN
+	  get_bib_command_or_entry_and_pr ();
+        END
       END
       a_close (CUR_BIB_FILE);
       INCR (bib_ptr);
@@ -2709,13 +2720,13 @@ BEGIN
   if (last_cite == Max_Cites)
   BEGIN
     BIB_XRETALLOC_NOSET ("cite_info", cite_info, StrNumber_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, Max_Cites + Max_Cites);
     BIB_XRETALLOC_NOSET ("cite_list", cite_list, StrNumber_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, Max_Cites + Max_Cites);
     BIB_XRETALLOC_NOSET ("entry_exists", entry_exists, Boolean_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, Max_Cites + Max_Cites);
     BIB_XRETALLOC ("type_list", type_list, HashPtr2_T,
-                   Max_Cites, Max_Cites + MAX_CITES);
+                   Max_Cites, Max_Cites + Max_Cites);
     while (last_cite < Max_Cites)
     BEGIN
       type_list[last_cite] = EMPTY;
@@ -2772,7 +2783,7 @@ BEGIN
   BEGIN
     field_ptr = Max_Fields;
     BIB_XRETALLOC ("field_info", field_info, StrNumber_T,
-                   Max_Fields, total_fields + MAX_FIELDS);
+                   Max_Fields, total_fields + Max_Fields);
     /* Initialize to |missing|.  */
     while (field_ptr < Max_Fields)
     BEGIN
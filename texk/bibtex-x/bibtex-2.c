@@ -36,6 +36,7 @@
 **          get_bst_command_and_process
 **          get_the_top_level_aux_file_name
 **          hash_cite_confusion
+**          hash_overflow
 **          id_scanning_confusion
 **          illegl_literal_confusion
 **          init_command_execution
@@ -167,6 +168,7 @@ BEGIN
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 343 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
   WizFnLoc_T        wiz_ptr;
+  HashPtr2_T        wiz_loc;
 
 #ifdef TRACE
   if (Flag_trace) {
@@ -280,9 +282,9 @@ BEGIN
  * but does nothing else.
  ***************************************************************************/
 	    BEGIN
-	      pop_lit_stk (&pop_lit1, &pop_typ1);
-	      pop_lit_stk (&pop_lit2, &pop_typ2);
-	      pop_lit_stk (&pop_lit3, &pop_typ3);
+	      POP_LIT_STK (pop_lit1, pop_typ1);
+	      POP_LIT_STK (pop_lit2, pop_typ2);
+	      POP_LIT_STK (pop_lit3, pop_typ3);
 	      if (pop_typ1 != STK_FN)
 	      BEGIN
 		print_wrong_stk_lit (pop_lit1, pop_typ1, STK_FN);
@@ -426,8 +428,8 @@ BEGIN
  * either type is incorrect, it complains but does nothing else.
  ***************************************************************************/
 	    BEGIN
-	      pop_lit_stk (&r_pop_lt1, &r_pop_tp1);
-	      pop_lit_stk (&r_pop_lt2, &r_pop_tp2);
+	      POP_LIT_STK (r_pop_lt1, r_pop_tp1);
+	      POP_LIT_STK (r_pop_lt2, r_pop_tp2);
 	      if (r_pop_tp1 != STK_FN)
 	      BEGIN
 		print_wrong_stk_lit (r_pop_lt1, r_pop_tp1, STK_FN);
@@ -441,7 +443,7 @@ BEGIN
 		LOOP
 		BEGIN
 		  execute_fn (r_pop_lt2);
-		  pop_lit_stk (&pop_lit1, &pop_typ1);
+		  POP_LIT_STK (pop_lit1, pop_typ1);
 		  if (pop_typ1 != STK_INT)
 		  BEGIN
 		    print_wrong_stk_lit (pop_lit1, pop_typ1, STK_INT);
@@ -484,19 +486,49 @@ End_While_Label: DO_NOTHING;
  * To execute a |wiz_defined| function, we just execute all those
  * functions in its definition, except that the special marker
  * |quote_next_fn| means we push the next function onto the stack.
+ *
+ * Most of the functions in a definition only push a literal or a
+ * global integer, so those are pushed right here instead of through a
+ * recursive call; everything else (and everything, when tracing) still
+ * goes through |execute_fn|.
  ***************************************************************************/
       BEGIN
 	wiz_ptr = FN_INFO[ex_fn_loc];
-	while (wiz_functions[wiz_ptr] != END_OF_DEF)
+	while ((wiz_loc = wiz_functions[wiz_ptr]) != END_OF_DEF)
 	BEGIN
-	  if (wiz_functions[wiz_ptr] != QUOTE_NEXT_FN)
+	  if (wiz_loc == QUOTE_NEXT_FN)
 	  BEGIN
-	    execute_fn (wiz_functions[wiz_ptr]);
+	    INCR (wiz_ptr);
+#ifdef TRACE
+	    if (Flag_trace)
+	      push_lit_stk (wiz_functions[wiz_ptr], STK_FN);
+	    else
+#endif                      			/* TRACE */
+	    PUSH_LIT_STK (wiz_functions[wiz_ptr], STK_FN);
 	  END
+
+#ifdef TRACE
+	  else if (Flag_trace)
+	  BEGIN
+	    execute_fn (wiz_loc);
+	  END
+#endif                      			/* TRACE */
+
 	  else
 	  BEGIN
-	    INCR (wiz_ptr);
-	    push_lit_stk (wiz_functions[wiz_ptr], STK_FN);
+	    switch (fn_type[wiz_loc])
+	    BEGIN
+	      case INT_LITERAL:
+	      case INT_GLOBAL_VAR:
+		PUSH_LIT_STK (FN_INFO[wiz_loc], STK_INT);
+		break;
+	      case STR_LITERAL:
+		PUSH_LIT_STK (hash_text[wiz_loc], STK_STR);
+		break;
+	      default:
+		execute_fn (wiz_loc);
+		break;
+	    END
 	  END
 	  INCR (wiz_ptr);
 	END
@@ -1973,6 +2005,7 @@ BEGIN
  ***************************************************************************/
   Boolean_T	check_cmnd_line;
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 101 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
+  HashLoc_T	aux_loc;
 
   check_cmnd_line = TRUE;
   LOOP
@@ -2070,10 +2103,12 @@ BEGIN
 	  buffer[name_ptr] = xord[name_of_file[name_ptr - 1]];
 	  INCR (name_ptr);
 	END
-	top_lev_str = hash_text[str_lookup (buffer, 1, aux_name_length,
-					    TEXT_ILK, DO_INSERT)];
-	CUR_AUX_STR = hash_text[str_lookup (buffer, 1, name_length,
-					    AUX_FILE_ILK, DO_INSERT)];
+	aux_loc = str_lookup (buffer, 1, aux_name_length, TEXT_ILK,
+			      DO_INSERT);
+	top_lev_str = hash_text[aux_loc];
+	aux_loc = str_lookup (buffer, 1, name_length, AUX_FILE_ILK,
+			      DO_INSERT);
+	CUR_AUX_STR = hash_text[aux_loc];
 	if (hash_found)
 	BEGIN
 
@@ -2120,6 +2155,58 @@ END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 137 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
 
+
+
+/***************************************************************************
+ * WEB section number:	 71
+ * ~~~~~~~~~~~~~~~~~~~
+ * When every hash location has been handed out, the arrays indexed by
+ * location are doubled in place (so existing locations stay valid) and
+ * |hash_slot| is doubled and rebuilt from the strings already in
+ * |str_pool|, oldest location first.
+ ***************************************************************************/
+void          hash_overflow (void)
+BEGIN
+  Integer_T		new_size;
+  HashLoc_T		p;
+  HashPointer_T		s;
+  PoolPointer_T		k;
+  unsigned long		h;
+
+  new_size = Hash_Size + Hash_Size;
+  BIB_XRETALLOC_NOSET ("fn_type", fn_type, FnClass_T, Hash_Size, new_size);
+  BIB_XRETALLOC_NOSET ("hash_ilk", hash_ilk, StrIlk_T, Hash_Size, new_size);
+  BIB_XRETALLOC_NOSET ("ilk_info", ilk_info, Integer_T, Hash_Size, new_size);
+  BIB_XRETALLOC ("hash_text", hash_text, StrNumber_T, Hash_Size, new_size);
+  for (p = hash_used; p <= HASH_MAX; p++)
+  BEGIN
+    hash_text[p] = 0;
+  END
+
+  BIB_XRETALLOC ("hash_slot", hash_slot, HashPointer_T, Hash_Slots,
+		 Hash_Slots + Hash_Slots);
+  for (s = 0; s < Hash_Slots; s++)
+  BEGIN
+    hash_slot[s] = EMPTY;
+  END
+  for (p = HASH_BASE; p < hash_used; p++)
+  BEGIN
+    h = STR_HASH_INIT;
+    for (k = str_start[hash_text[p]]; k < str_start[hash_text[p] + 1]; k++)
+    BEGIN
+      h = STR_HASH (h, str_pool[k]);
+    END
+    s = (HashPointer_T) (h & (Hash_Slots - 1));
+    while (hash_slot[s] != EMPTY)
+    BEGIN
+      s = (s + 1) & (Hash_Slots - 1);
+    END
+    hash_slot[s] = p;
+  END
+END
+/*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION  71 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
+
+
 /***************************************************************************
  * WEB section number:	 165
  * ~~~~~~~~~~~~~~~~~~~
@@ -2200,26 +2287,11 @@ BEGIN
     if (MAX_PRINT_LINE >= Buf_Size)
         bad = 10 * bad + 3;
 
-    if (Hash_Prime < 128)
-        bad = 10 * bad + 4;
-
-    if (Hash_Prime > Hash_Size)
-        bad = 10 * bad + 5;
-
     /*
-    ** The original WEB version of BibTeX imposed a maximum value of
-    ** 16320 on Hash_Prime.  A WEB constant was defined:
-    **
-    **   MAX_HASH_VALUE = (Hash_Prime + Hash_Prime - 2 + 127)
-    **
-    ** but, because WEB constants are limited to 32767, Hash_Prime was
-    ** consequently limited to a maximum of (32767 + 2 - 127) / 2 = 16321.
-    **
-    ** We're using C #defines, so that limit doesn't apply.  The
-    ** following original sanity check is therefore commented out.
-    **
-    **   if (Hash_Prime >= (16384 - 64))
-    **     bad = 10 * bad + 6;
+    ** The original WEB version of BibTeX checked Hash_Prime here
+    ** (bad values 4, 5 and 6).  The hash table is now probed by
+    ** open addressing and grows on demand, so there is no Hash_Prime
+    ** and those checks no longer apply.
     */
 
     if (Max_Strings > Hash_Size)
@@ -2660,10 +2732,15 @@ BEGIN
  ***************************************************************************/
     for (k=HASH_BASE; k<=HASH_MAX; k++)
     BEGIN
-        hash_next[k] = EMPTY;
         hash_text[k] = 0;
     END
-    hash_used = HASH_MAX + 1;
+    for (k=0; k<Hash_Slots; k++)
+    BEGIN
+        hash_slot[k] = EMPTY;
+    END
+    hash_used = HASH_BASE;
+    hash_lookups = 0;
+    hash_probes = 0;
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 67 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
 /***************************************************************************
@@ -3282,7 +3359,8 @@ StrNumber_T       make_string (void)
 BEGIN
   if (str_ptr == Max_Strings)
   BEGIN
-    BIBTEX_OVERFLOW ("number of strings ", Max_Strings);
+    BIB_XRETALLOC ("str_start", str_start, PoolPointer_T, Max_Strings,
+		   Max_Strings + Max_Strings);
   END
   INCR (str_ptr);
   str_start[str_ptr] = pool_ptr;
@@ -3560,13 +3638,14 @@ END
  * WEB section number:	 53
  * ~~~~~~~~~~~~~~~~~~~
  * To test if there is room to append |l| more characters to |str_pool|,
- * we shall write |str_room(l)|, which aborts \BibTeX\ and gives an
- * error message if there isn't enough room.
+ * we shall write |str_room(l)|, which enlarges |str_pool| if there
+ * isn't enough room.  The pool at least doubles each time, so filling
+ * it costs amortized constant time per character.
  ***************************************************************************/
 void          pool_overflow (void)
 BEGIN
-  BIB_XRETALLOC ("str_pool", str_pool, ASCIICode_T,
-                 Pool_Size, Pool_Size + POOL_SIZE);
+  BIB_XRETALLOC ("str_pool", str_pool, ASCIICode_T, Pool_Size,
+                 Pool_Size + ((Pool_Size > POOL_SIZE) ? Pool_Size : POOL_SIZE));
 END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION  53 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
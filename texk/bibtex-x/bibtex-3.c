@@ -2469,44 +2469,47 @@ HashLoc_T         str_lookup (BufType_T buf, BufPointer_T j, BufPointer_T l,
 			      StrIlk_T ilk, Boolean_T insert_it)
 BEGIN
   HashLoc_T		str_lookup;
-  long                  h;
+  unsigned long		h;
+  HashPointer_T		s;
   HashLoc_T		p;
   BufPointer_T		k;
   Boolean_T		old_string;
   StrNumber_T		str_num;
 
+  if ((insert_it) && (hash_used > HASH_MAX))
+  BEGIN
+    hash_overflow ();
+  END
+
 /***************************************************************************
  * WEB section number:	69
  * ~~~~~~~~~~~~~~~~~~~
- * The value of |Hash_Prime| should be roughly 85\% of |Hash_Size|, and
- * it should be a prime number
- * (it should also be less than $2^14 + 2^6 = 16320$ because of
- * WEB's simple-macro bound).  The theory of hashing tells us to expect
- * fewer than two table probes, on the average, when the search is
- * successful.
- *
- * NOTE: the limit imposed on the value of Hash_Prime no longer applies
- *       because we are using C #defines.
+ * The string is hashed with the 32-bit FNV-1a function, which spreads
+ * short identifiers well at the cost of one multiplication per
+ * character.  Because |hash_slot| is at most half full, the theory of
+ * hashing tells us to expect fewer than two probes, on the average,
+ * when the search is successful.
  ***************************************************************************/
   BEGIN
-    h = 0;
+    h = STR_HASH_INIT;
     k = j;
     while (k < (j + l))
     BEGIN
-      h = h + h + buf[k];
-      while (h >= Hash_Prime)
-	h = h - Hash_Prime;
+      h = STR_HASH (h, buf[k]);
       INCR (k);
     END
   END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION  69 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
-  p = h + HASH_BASE;
+  s = (HashPointer_T) (h & (Hash_Slots - 1));
   hash_found = FALSE;
   old_string = FALSE;
   str_num = 0;	/* avoid uninitialized warning */
+  INCR (hash_lookups);
   LOOP
   BEGIN
+    INCR (hash_probes);
+    p = hash_slot[s];
 
 /***************************************************************************
  * WEB section number:	70
@@ -2515,27 +2518,25 @@ BEGIN
  * string; note that even if we have, we'll still have to insert the pair
  * into the hash table if |str_ilk| doesn't match.
  ***************************************************************************/
+    if (p != EMPTY)
     BEGIN
-      if (hash_text[p] > 0)
+      if (str_eq_buf (hash_text[p], buf, j, l))
       BEGIN
-	if (str_eq_buf (hash_text[p], buf, j, l))
+	if (hash_ilk[p] == ilk)
 	BEGIN
-	  if (hash_ilk[p] == ilk)
-	  BEGIN
-	    hash_found = TRUE;
-	    goto Str_Found_Label;
-	  END
-	  else
-	  BEGIN
-	    old_string = TRUE;
-	    str_num = hash_text[p];
-	  END
+	  hash_found = TRUE;
+	  goto Str_Found_Label;
+	END
+	else
+	BEGIN
+	  old_string = TRUE;
+	  str_num = hash_text[p];
 	END
       END
     END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION  70 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
-    if (hash_next[p] == EMPTY)
+    else
     BEGIN
       if ( ! insert_it)
       BEGIN
@@ -2545,22 +2546,13 @@ BEGIN
 /***************************************************************************
  * WEB section number:	71
  * ~~~~~~~~~~~~~~~~~~~
- * This code inserts the pair in the appropriate unused location.
+ * This code inserts the pair in the next unused location and records
+ * that location in the empty slot the probe stopped at.
  ***************************************************************************/
       BEGIN
-	if (hash_text[p] > 0)
-	BEGIN
-	  REPEAT
-	  BEGIN
-	    if (HASH_IS_FULL)
-	    BEGIN
-	      BIBTEX_OVERFLOW ("hash size ", Hash_Size);
-	    END
-	    DECR (hash_used);
-	  END UNTIL (hash_text[hash_used] == 0);
-	  hash_next[p] = hash_used;
-	  p = hash_used;
-	END
+	p = hash_used;
+	INCR (hash_used);
+	hash_slot[s] = p;
 	if (old_string)
 	BEGIN
 	  hash_text[p] = str_num;
@@ -2582,7 +2574,7 @@ BEGIN
 
       goto Str_Found_Label;
     END
-    p = hash_next[p];
+    s = (s + 1) & (Hash_Slots - 1);
   END
 Str_Not_Found_Label: DO_NOTHING;
 Str_Found_Label: str_lookup = p;
@@ -1316,7 +1316,7 @@ END
  ***************************************************************************/
 void          x_gets (void)
 BEGIN
-  pop_lit_stk (&pop_lit1, &pop_typ1);
+  POP_LIT_STK (pop_lit1, pop_typ1);
   pop_lit_stk (&pop_lit2, &pop_typ2);
   if (pop_typ1 != STK_FN)
   BEGIN
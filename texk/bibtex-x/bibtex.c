@@ -411,7 +411,10 @@ Close_Up_Shop_Label:
       TRACE_PR_LN3 (" Fields:           %6ld out of %ld",
                     (long) field_ptr, (long) Max_Fields);
       TRACE_PR_LN3 (" Hash table:       %6ld out of %ld",
-                    (long) hash_used, (long) Hash_Size);
+                    (long) (hash_used - HASH_BASE), (long) Hash_Size);
+      TRACE_PR_LN3 (" Hash lookups:     %6lu, %.2f probes each",
+                    hash_lookups, (hash_lookups > 0)
+                    ? (double) hash_probes / hash_lookups : 0.0);
       TRACE_PR_LN3 (" Strings:          %6ld out of %ld",
                     (long) str_ptr, (long) Max_Strings);
       TRACE_PR_LN3 (" Free string pool: %6ld out of %ld",
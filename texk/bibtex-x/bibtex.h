@@ -504,10 +504,17 @@
  * Programming).  Once a string enters the table, it is never removed.
  * The actual sequence of characters forming a string is stored in the
  * |str_pool| array.
+ *
+ * This implementation hands out hash locations sequentially from
+ * |HASH_BASE| and finds them through |hash_slot|, an open-addressing
+ * index of |Hash_Slots| entries (a power of two) probed linearly.
+ * Both are doubled when they fill up, so the table has no fixed
+ * capacity; locations never move once handed out.
  ***************************************************************************/
 #define HASH_BASE                   (EMPTY + 1)
 #define HASH_MAX                    (HASH_BASE + Hash_Size - 1)
-#define HASH_IS_FULL                ((hash_used) == (HASH_BASE))
+#define STR_HASH_INIT               2166136261UL
+#define STR_HASH(H, C)              ((((H) ^ (C)) * 16777619UL) & 0xFFFFFFFFUL)
 #define TEXT_ILK                    0
 #define INTEGER_ILK                 1
 #define AUX_COMMAND_ILK             2
@@ -541,7 +548,6 @@
  * string wouldn't be inserted into |str_pool| because it would already be
  * there.
  ***************************************************************************/
-#define MAX_HASH_VALUE              (Hash_Prime + Hash_Prime - 2 + 127)
 #define DO_INSERT                   TRUE
 #define DONT_INSERT                 FALSE
 
@@ -846,7 +852,7 @@
  * |wiz_functions| explained below.
  ***************************************************************************/
 #define QUOTE_NEXT_FN               (HASH_BASE - 1)
-#define END_OF_DEF                  (HASH_MAX + 1)
+#define END_OF_DEF                  (-1)
 
 /***************************************************************************
  * WEB section number:  161
@@ -988,7 +994,7 @@
  * ~~~~~~~~~~~~~~~~~~~
  * These global variables are used ...
  ***************************************************************************/
-#define UNDEFINED                   (HASH_MAX + 1)
+#define UNDEFINED                   (-1)
 
 /***************************************************************************
  * WEB section number:  221
@@ -1270,6 +1276,32 @@
 #define SHORT_LIST                  10
 #define END_OFFSET                  4
 
+/***************************************************************************
+ * WEB section number:  307
+ * ~~~~~~~~~~~~~~~~~~~
+ * This macro is |push_lit_stk| without the tracing, for the inner loop
+ * of |execute_fn|; it calls the procedure only when the stack is full.
+ * Likewise |POP_LIT_STK| calls |pop_lit_stk| only when the stack is
+ * empty or the top is a string (which might have to be flushed).
+ ***************************************************************************/
+#define PUSH_LIT_STK(X, Y)          {\
+            if (lit_stk_ptr < Lit_Stk_Size) {\
+                lit_stack[lit_stk_ptr] = (X);\
+                lit_stk_type[lit_stk_ptr] = (Y);\
+                INCR (lit_stk_ptr);\
+            } else {\
+                push_lit_stk ((X), (Y));\
+            }}
+#define POP_LIT_STK(X, Y)           {\
+            if ((lit_stk_ptr > 0)\
+                && (lit_stk_type[lit_stk_ptr - 1] != STK_STR)) {\
+                DECR (lit_stk_ptr);\
+                (X) = lit_stack[lit_stk_ptr];\
+                (Y) = lit_stk_type[lit_stk_ptr];\
+            } else {\
+                pop_lit_stk (&(X), &(Y));\
+            }}
+
 /***************************************************************************
  * WEB section number:  308
  * ~~~~~~~~~~~~~~~~~~~
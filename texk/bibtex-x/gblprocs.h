@@ -207,6 +207,7 @@ void                    get_bst_command_and_process (void);
 void                    get_the_top_level_aux_file_name (void);
 
 void                    hash_cite_confusion (void);
+void                    hash_overflow (void);
 
 void                    id_scanning_confusion (void);
 void                    illegl_literal_confusion (void);
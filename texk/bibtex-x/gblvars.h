@@ -218,6 +218,8 @@ __EXTERN__ HashLoc_T                    fn_loc;
 __EXTERN__ Integer_T                    glob_chr_ptr;
 
 __EXTERN__ Boolean_T                    hash_found;
+__EXTERN__ unsigned long                hash_lookups;
+__EXTERN__ unsigned long                hash_probes;
 __EXTERN__ Integer16_T		        hash_used;
 __EXTERN__ Integer8_T                   history;
 
@@ -400,7 +402,7 @@ __EXTERN__ Integer_T                   *glb_str_end;
 __EXTERN__ StrNumber_T                 *glb_str_ptr;
 __EXTERN__ ASCIICode_T                 *global_strs;
 __EXTERN__ StrIlk_T                    *hash_ilk;
-__EXTERN__ HashPointer_T               *hash_next;
+__EXTERN__ HashPointer_T               *hash_slot;
 __EXTERN__ StrNumber_T                 *hash_text;
 __EXTERN__ Integer_T                   *ilk_info;
 __EXTERN__ Integer_T                   *lit_stack;
@@ -434,6 +436,7 @@ __EXTERN__ Boolean_T                    Flag_8bit_alpha;
 __EXTERN__ Boolean_T                    Flag_big;
 __EXTERN__ Boolean_T                    Flag_debug;
 __EXTERN__ Boolean_T                    Flag_huge;
+__EXTERN__ Boolean_T                    Flag_index;
 __EXTERN__ Boolean_T                    Flag_stats;
 __EXTERN__ Boolean_T                    Flag_trace;
 __EXTERN__ Boolean_T                    Flag_wolfgang;
@@ -453,8 +456,8 @@ __EXTERN__ char                        *Str_csfile;
 __EXTERN__ Integer_T                    Buf_Size;
 __EXTERN__ Integer_T                    Ent_Str_Size;
 __EXTERN__ Integer_T                    Glob_Str_Size;
-__EXTERN__ Integer_T                    Hash_Prime;
 __EXTERN__ Integer_T                    Hash_Size;
+__EXTERN__ Integer_T                    Hash_Slots;
 __EXTERN__ Integer_T                    Lit_Stk_Size;
 __EXTERN__ Integer_T                    Max_Bib_Files;
 __EXTERN__ Integer_T                    Max_Cites;
@@ -0,0 +1,55 @@
+#! /bin/sh
+# this file is part of the bibtex-x package
+# it times BibTeX8 formatting a large generated database with several styles
+# Compare the times before and after a change to the .bst interpreter
+
+echo "This is bench.sh"
+echo "[BIBTEX8_PATH=/the/path/to/bibtex8 ][BIBTEX_BENCH_ENTRIES=100000 ][BIBTEX_BENCH_STYLES='a.bst b.bst' ]./bench.sh"
+
+test -z "$srcdir" && srcdir=`cd \`dirname $0\`/.. && pwd`
+
+if test -z "$BIBTEX8_PATH"
+then
+BIBTEX8_PATH="$(which bibtex8)"
+fi
+if ! test -f "$BIBTEX8_PATH" || ! test -x "$BIBTEX8_PATH"
+then
+    echo "No executable file at $BIBTEX8_PATH"
+    exit 1
+fi
+echo "bibtex8 command used: $BIBTEX8_PATH"
+
+if test -z "$BIBTEX_BENCH_ENTRIES"
+then
+BIBTEX_BENCH_ENTRIES=100000
+fi
+if test -z "$BIBTEX_BENCH_STYLES"
+then
+BIBTEX_BENCH_STYLES="$srcdir/../tests/texmf/plain.bst $srcdir/../web2c/tests/apalike.bst"
+fi
+
+mkdir -p bibtex_bench
+cd bibtex_bench
+awk -v n=$BIBTEX_BENCH_ENTRIES 'BEGIN {
+  print "@string{jgr = \"Journal of Generic Research\"}"
+  for (i = 0; i < n; i++) {
+    if (i % 3 == 0)
+      printf "@Article{k%d,\n  author = {A. Author%d and B. {van} Writer and C. Third},\n  title = \"On the {T}heory of %d Things\",\n  journal = jgr, volume = %d, pages = {1--%d},\n  year = %d\n}\n", i, i, i, i % 40, i % 300 + 2, 1900 + i % 120
+    else if (i % 3 == 1)
+      printf "@Book{k%d,\n  author = \"Person%d, Charles\",\n  title = {Book {(}%d)},\n  publisher = {Some {Publisher} Inc.},\n  year = \"19%02d\"\n}\n", i, i, i, i % 100
+    else
+      printf "@InProceedings{k%d,\n  author = {D. Speaker%d},\n  title = {Talk %d},\n  booktitle = {Proceedings %d},\n  pages = {1--%d}, year = 2000\n}\n", i, i, i, i % 50, i % 300 + 2
+  }
+}' > bench.bib
+
+for bst in $BIBTEX_BENCH_STYLES
+do
+    style=`basename $bst .bst`
+    cp "$bst" .
+    printf '\\citation{*}\n\\bibstyle{%s}\n\\bibdata{bench}\n' $style > bench.aux
+    rm -f bench.bbl bench.blg
+    echo "style=$style"
+    time "$BIBTEX8_PATH" bench >/dev/null
+done
+ls -l bench.bbl
+cd ..
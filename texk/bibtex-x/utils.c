@@ -32,6 +32,7 @@
 **          mymalloc
 **          myrealloc
 **          parse_cmd_line
+**          read_bib_file_indexed
 **          report_bibtex_capacity
 **          report_search_paths
 **          set_array_sizes
@@ -158,6 +159,9 @@
         FPRINTF (log_file, "    %-15s = %7ld\n", #_a, (long) _a)
 #define ISEMPTYSTR(_a)  ((_a == NULL) || (*_a == '\0'))
 #define NULLCHECK(_a)   (ISEMPTYSTR(_a) ? "<undefined>" : _a)
+#ifndef IS_DIR_SEP
+#define IS_DIR_SEP(_c)  ((_c) == '/')
+#endif
 
 
 /*-
@@ -179,6 +183,7 @@ static struct option long_options[] = {
 #endif
     {"debug",           VALUE_REQD, 0, 'd'},
     {"help",            VALUE_NONE, 0, '?'},
+    {"index",           VALUE_NONE, 0, 'i'},
     {"statistics",      VALUE_NONE, 0, 's'},
     {"trace",           VALUE_NONE, 0, 't'},
 #ifndef UTF_8
@@ -210,7 +215,7 @@ static const char *getopt_str =
 #ifndef UTF_8
   "78c:"
 #endif
-  "d:?stv"
+  "d:?istv"
 #ifdef UTF_8
   "l:o:"
 #endif
@@ -264,7 +269,7 @@ static int              sort_weight;
 **      StrNumber_T     glb_str_ptr[Max_Glob_Strs];
 **	ASCIICode_T     global_strs[Max_Glob_Strs][Glob_Str_Size + 1];;
 **	StrIlk_T        hash_ilk[Hash_Size + 1];
-**	HashPointer_T   hash_next[Hash_Size + 1];
+**	HashPointer_T   hash_slot[Hash_Slots];
 **	StrNumber_T     hash_text[Hash_Size + 1];
 **	Integer_T       ilk_info[Hash_Size + 1];
 **      Integer_T       lit_stack[Lit_Stk_Size + 1];
@@ -379,10 +384,10 @@ static void allocate_arrays (void)
     hash_ilk = (StrIlk_T *) mymalloc (bytes_required, "hash_ilk");
 
     /*
-    ** HashPointer_T hash_next[Hash_Size + 1];
+    ** HashPointer_T hash_slot[Hash_Slots];
     */
-    bytes_required = (Hash_Size + 1) * (unsigned long) sizeof (HashPointer_T);
-    hash_next = (HashPointer_T *) mymalloc (bytes_required, "hash_next");
+    bytes_required = Hash_Slots * (unsigned long) sizeof (HashPointer_T);
+    hash_slot = (HashPointer_T *) mymalloc (bytes_required, "hash_slot");
 
     /*
     ** StrNumber_T hash_text[Hash_Size + 1];
@@ -961,6 +966,7 @@ FILE *open_op_file (void)
 **                              and sort definition file
 **      -d  --debug TYPE        report debugging information.  TYPE is one or
 **                              more of all, csf, io, mem, misc, search.
+**      -i  --index             read the database files by way of an index
 **      -s  --statistics        report internal statistics
 **      -t  --trace             report execution tracing
 **      -v  --version           report BibTeX version\n
@@ -994,6 +1000,7 @@ void parse_cmd_line (int argc, char **argv)
     Flag_big = FALSE;
     Flag_debug = FALSE;
     Flag_huge = FALSE;
+    Flag_index = FALSE;
     Flag_wolfgang = FALSE;
     Flag_stats = FALSE;
     Flag_trace = FALSE;
@@ -1050,6 +1057,10 @@ void parse_cmd_line (int argc, char **argv)
                 Flag_huge = TRUE;
                 break;
 
+            case 'i':       /**************** -i, --index **************/
+                Flag_index = TRUE;
+                break;
+
 #ifdef UTF_8
             case 'l':       /**************** -l, --language ***********/
                 Flag_language =TRUE;
@@ -1206,8 +1217,8 @@ void report_bibtex_capacity (void)
         LOG_CAPACITY (Buf_Size);
         LOG_CAPACITY (Ent_Str_Size);
         LOG_CAPACITY (Glob_Str_Size);
-        LOG_CAPACITY (Hash_Prime);
         LOG_CAPACITY (Hash_Size);
+        LOG_CAPACITY (Hash_Slots);
         LOG_CAPACITY (Lit_Stk_Size);
         LOG_CAPACITY (Max_Bib_Files);
         LOG_CAPACITY (Max_Cites);
@@ -1317,7 +1328,8 @@ static void setup_bound_variable (Integer_T *var, const char *name,
 **
 **  Determine |ent_str_size|, |glob_str_size|, and |max_strings| from the
 **  environment, configuration file, or default value.  Set
-**  |hash_size:=max_strings|, but not less than |HASH_SIZE|.
+**  |hash_size:=max_strings|, but not less than |HASH_SIZE|, and give
+**  the hash table's open-addressing index at least twice as many slots.
 **============================================================================
 */
 static void setup_params (void)
@@ -1341,58 +1353,12 @@ static void setup_params (void)
     Hash_Size = Max_Strings;
     if (Hash_Size < HASH_SIZE)
         Hash_Size = HASH_SIZE;
+    Hash_Slots = 1;
+    while (Hash_Slots < 2 * Hash_Size)
+        Hash_Slots *= 2;
 }                               /* setup_params() */
 
 
-/*-
-**============================================================================
-** compute_hash_prime()
-**
-**  We use the algorithm from Knuth's \.{primes.web} to compute
-**  |hash_prime| as the smallest prime number not less than 85\%
-**  of |hash_size| (and |>=128|).
-**
-**  This algorithm uses two arrays |primes| and |mult|.  We use the
-**  already allocated |hash_next| and |hash_text| for that purpose.
-**============================================================================
-*/
-#define primes hash_next
-#define mult hash_text
-static void compute_hash_prime (void)
-{
-    Integer32_T Hash_Want = (Hash_Size / 20) * 17; /* 85\% of |hash_size| */
-    Integer32_T k = 1; /*number of prime numbers $p_i$ in |primes| */
-    Integer32_T j = 1; /* a prime number candidate */
-    Integer32_T o = 2; /* number of odd multiples of primes in |mult| */
-    Integer32_T square = 9; /* $p_o^2$ */
-    Integer32_T n; /* loop index */
-    Boolean_T j_prime; /* is |j| a prime? */
-
-    debug_msg (DBG_MEM, "Computing Hash_Prime ... ");
-
-    primes[k] = Hash_Prime = 2;
-    while (Hash_Prime < Hash_Want) {
-        do {
-            j += 2;
-            if (j == square) {
-                mult[o++] = j;
-                j += 2;
-                square = primes[o] * primes[o];
-            }
-            n = 2;
-            j_prime = TRUE;
-            while ((n < o) && j_prime) {
-                while (mult[n] < j)
-                    mult[n] += 2 * primes[n];
-                if (mult[n++] == j)
-                    j_prime = FALSE;
-            }
-        } while (!j_prime);
-        primes[++k] = Hash_Prime = j;
-    }
-}                               /* compute_hash_prime() */
-
-
 /*-
 **============================================================================
 ** set_array_sizes()
@@ -1407,14 +1373,15 @@ static void compute_hash_prime (void)
 **    Parameter       Cmd   Standard       --big      --huge  --wolfgang
 **    ------------------------------------------------------------------
 **    Buf_Size        *** initialy 20000, increased as required ***
-**    Hash_Prime      *** computed from Hash_Size ***
-**    Hash_Size       *** determined from Max_Strings ***
+**    Hash_Size       *** determined from Max_Strings, increased as required ***
+**    Hash_Slots      *** power of two >= 2 * Hash_Size ***
 **    Max_Bib_Files   *** initialy 20, increased as required ***
 **    Max_Cites       *** initialy 750, increased as required ***
 **    Max_Ent_Ints    *** as required ***
 **    Max_Ent_Strs    *** as required ***
 **    Max_Fields      *** initialy 5000, increased as required ***
 **    Max_Strings     Y        4,000      10,000      19,000      30,000
+**                    (initial values, increased as required)
 **    Pool_Size       *** initialy 65,000, increased as required ***
 **    Wiz_Fn_Space    *** initialy 3000, increased as required ***
 **    ------------------------------------------------------------------
@@ -1448,11 +1415,10 @@ void set_array_sizes (void)
 
 
     allocate_arrays ();
-    compute_hash_prime ();
 
 
-    debug_msg (DBG_MEM, "Hash_Prime = %d, Hash_Size = %d", 
-               Hash_Prime, Hash_Size);
+    debug_msg (DBG_MEM, "Hash_Size = %d, Hash_Slots = %d",
+               Hash_Size, Hash_Slots);
     debug_msg (DBG_MEM, "Buf_Size = %d, Max_Bib_Files = %d", 
                Buf_Size, Max_Bib_Files);
     debug_msg (DBG_MEM, "Max_Cites = %d, Max_Fields = %d", 
@@ -1469,29 +1435,6 @@ void set_array_sizes (void)
     */
     debug_msg(DBG_MISC, "Sanity checking capacity values ... ");
     
-    if (Hash_Prime < 128)
-        usage ("Hash_Prime (%d) must be >= 128", Hash_Prime);
-        
-    if (Hash_Prime > Hash_Size)
-        usage ("Hash_Prime (%d) must be <= Hash_Size (%d)",
-               Hash_Prime, Hash_Size);
-
-    /*
-    ** The original WEB version of BibTeX imposed a maximum value of
-    ** 16321 on Hash_Prime.  A WEB constant was defined:
-    **
-    **   MAX_HASH_VALUE = (Hash_Prime + Hash_Prime - 2 + 127)
-    **
-    ** but, because WEB constants are limited to 32767, Hash_Prime was
-    ** consequently limited to a maximum of (32767 + 2 - 127) / 2 = 16321.
-    **
-    ** We're using C #defines, so that limit doesn't apply.  The
-    ** following original sanity check is therefore commented out.
-    **
-    **   if (Hash_Prime >= (16384 - 64))
-    **     usage ("Hash_Prime (%d) must be < %d", Hash_Prime, (16384-64));
-    */
-
     if (Max_Strings > Hash_Size)
         usage ("Max_Strings (%d) must be <= Hash_Size (%d)",
                Max_Strings, Hash_Size);
@@ -1545,6 +1488,9 @@ void usage (const char *printf_fmt, ...)
     FSO ("                          or more of all, csf, io, mem, misc, search.\n");
 #endif                          /* DEBUG */
 
+    FSO ("  -i  --index             read the database files by way of an index\n");
+    FSO ("                          kept in a .bix file for each of them\n");
+
 #ifdef STAT
     FSO ("  -s  --statistics        report internal statistics\n");
 #endif                          /* STAT */
@@ -1573,6 +1519,515 @@ void usage (const char *printf_fmt, ...)
 
 
 
+/*-
+******************************************************************************
+******************************************************************************
+**
+**  Functions for the .bib file index.
+**
+**      read_bib_file_indexed
+**
+**  With the --index option, the position of each entry and command in a
+**  database file is kept in a sidecar file with the extension ".bix" in
+**  the current directory, together with the size and a hash of the
+**  database contents.  When the index is valid, only the commands and the
+**  entries whose keys are on the citation list are scanned, instead of
+**  the whole file.
+**
+******************************************************************************
+******************************************************************************
+*/
+
+/*
+** The index format version and extension.
+*/
+#define BIX_HEADER              "% BibTeX database index 1"
+#define BIX_EXTENSION           ".bix"
+
+/*
+** One index record: where an entry or a command starts.  The position
+** is the file offset of the line holding the `@', since the database is
+** read line by line.  Only entries have a key, which is kept verbatim in
+** a pool shared by all records.
+*/
+typedef struct {
+    long                offset;
+    Integer_T           line;
+    Integer_T           column;
+    char                kind;
+    Integer_T           key;
+    Integer_T           key_len;
+} BibIndexRec_T;
+
+#define BIX_ENTRY               'e'
+#define BIX_COMMAND             'c'
+
+static BibIndexRec_T   *bix_recs = NULL;
+static Integer_T        bix_num_recs;
+static Integer_T        bix_max_recs = 0;
+static unsigned char   *bix_keys = NULL;
+static Integer_T        bix_keys_len;
+static Integer_T        bix_max_keys = 0;
+
+/*
+** 64-bit FNV-1a hash of the database contents.
+*/
+typedef unsigned long long BibHash_T;
+#define BIX_HASH_INIT           14695981039346656037ULL
+#define BIX_HASH(_h,_c)         (((_h) ^ (unsigned char) (_c)) * 1099511628211ULL)
+
+#define BIX_IS_WHITE(_c)        (lex_class[xord[_c]] == WHITE_SPACE)
+#define BIX_IS_EOL(_c)          ((_c) == '\n' || (_c) == '\r')
+
+
+
+/*-
+**============================================================================
+** bix_add_rec()
+**
+**  Append a record to the in-memory index.
+**============================================================================
+*/
+static void bix_add_rec (long offset, Integer_T line, Integer_T column,
+                         char kind, const unsigned char *key,
+                         Integer_T key_len)
+{
+    BibIndexRec_T      *rec;
+
+    if (bix_num_recs == bix_max_recs) {
+        bix_max_recs = (bix_max_recs == 0) ? 1024 : 2 * bix_max_recs;
+        bix_recs = (BibIndexRec_T *) myrealloc (bix_recs,
+                        bix_max_recs * (unsigned long) sizeof (BibIndexRec_T),
+                        "bix_recs");
+    }
+    if (bix_keys_len + key_len > bix_max_keys) {
+        while (bix_keys_len + key_len > bix_max_keys)
+            bix_max_keys = (bix_max_keys == 0) ? 16384 : 2 * bix_max_keys;
+        bix_keys = (unsigned char *) myrealloc (bix_keys,
+                        (unsigned long) bix_max_keys, "bix_keys");
+    }
+    rec = &bix_recs[bix_num_recs++];
+    rec->offset = offset;
+    rec->line = line;
+    rec->column = column;
+    rec->kind = kind;
+    rec->key = bix_keys_len;
+    rec->key_len = key_len;
+    if (key_len > 0)
+        memcpy (bix_keys + bix_keys_len, key, key_len);
+    bix_keys_len += key_len;
+}                               /* bix_add_rec() */
+
+
+
+/*-
+**============================================================================
+** bix_build()
+**
+**  Scan a database file to find where its entries and commands start,
+**  following the rules BibTeX uses when it reads the file: text outside
+**  entries is skipped up to an `@', @comment ends right after its name,
+**  and an entry or command extends to the outer delimiter that matches
+**  its opening `{' or `(', outside of braces and quoted strings.  The
+**  database key of an entry is read the way section 266 reads it.
+**
+**  Anything unusual, such as an `@' at the top level of an entry, makes
+**  the scan give up and return FALSE; the file is then read in full, so
+**  that BibTeX reports the problem as it always did.
+**============================================================================
+*/
+enum bix_state {
+    BIX_OUTSIDE, BIX_BEFORE_TYPE, BIX_TYPE, BIX_BEFORE_DELIM,
+    BIX_BEFORE_KEY, BIX_KEY, BIX_BODY
+};
+
+static Boolean_T bix_build (AlphaFile_T f, long *size, BibHash_T *hash)
+{
+    enum bix_state      state = BIX_OUTSIDE;
+    BibHash_T           h = BIX_HASH_INIT;
+    long                n = 0;
+    long                line_offset = 0, at_offset = 0;
+    Integer_T           line = 0, at_line = 0, at_column = 0;
+    Integer_T           column = 0;
+    Boolean_T           command = FALSE, in_quote = FALSE;
+    int                 close_delim = 0, depth = 0;
+    unsigned char      *token;
+    Integer_T           token_len = 0;
+    int                 c;
+
+    bix_num_recs = 0;
+    bix_keys_len = 0;
+    token = (unsigned char *) mymalloc ((unsigned long) Buf_Size + 1, "token");
+    rewind (f);
+    line_offset = ftell (f);
+    line = 1;
+    for (;;) {
+        c = getc (f);
+        if (c == EOF)
+            break;
+        h = BIX_HASH (h, c);
+        n++;
+        if (BIX_IS_EOL (c)) {
+            /*
+            ** Line ends are white space everywhere but in an entry type
+            ** or key, which they terminate.
+            */
+            if (state == BIX_TYPE || state == BIX_KEY)
+                goto Token_End;
+            goto Next_Line;
+        }
+
+Reprocess:
+        switch (state) {
+            case BIX_OUTSIDE:
+                if (c == '@') {
+                    at_offset = line_offset;
+                    at_line = line;
+                    at_column = column;
+                    state = BIX_BEFORE_TYPE;
+                }
+                break;
+
+            case BIX_BEFORE_TYPE:
+                if (BIX_IS_WHITE (c))
+                    break;
+                if (lex_class[xord[c]] == NUMERIC
+                        || id_class[xord[c]] != LEGAL_ID_CHAR)
+                    goto Give_Up;
+                token_len = 0;
+                state = BIX_TYPE;
+                /* fall through */
+
+            case BIX_TYPE:
+                if (id_class[xord[c]] == LEGAL_ID_CHAR) {
+                    if (token_len >= Buf_Size)
+                        goto Give_Up;
+                    token[token_len++] = (unsigned char) c;
+                    break;
+                }
+                if ( ! BIX_IS_WHITE (c) && c != '{' && c != '(')
+                    goto Give_Up;
+                goto Token_End;
+
+            case BIX_BEFORE_DELIM:
+                if (BIX_IS_WHITE (c))
+                    break;
+                if (c == '{')
+                    close_delim = '}';
+                else if (c == '(')
+                    close_delim = ')';
+                else
+                    goto Give_Up;
+                depth = 0;
+                in_quote = FALSE;
+                if (command) {
+                    bix_add_rec (at_offset, at_line, at_column, BIX_COMMAND,
+                                 NULL, 0);
+                    state = BIX_BODY;
+                } else
+                    state = BIX_BEFORE_KEY;
+                break;
+
+            case BIX_BEFORE_KEY:
+                if (BIX_IS_WHITE (c))
+                    break;
+                token_len = 0;
+                state = BIX_KEY;
+                /* fall through */
+
+            case BIX_KEY:
+                if (c != ',' && ! BIX_IS_WHITE (c)
+                        && ! (close_delim == '}' && c == '}')) {
+                    if (token_len >= Buf_Size)
+                        goto Give_Up;
+                    token[token_len++] = (unsigned char) c;
+                    break;
+                }
+                goto Token_End;
+
+            case BIX_BODY:
+                if (in_quote) {
+                    if (c == '{')
+                        depth++;
+                    else if (c == '}') {
+                        if (depth == 0)
+                            goto Give_Up;
+                        depth--;
+                    } else if (c == '"' && depth == 0)
+                        in_quote = FALSE;
+                } else if (c == '{')
+                    depth++;
+                else if (c == '}') {
+                    if (depth > 0)
+                        depth--;
+                    else if (close_delim == '}')
+                        state = BIX_OUTSIDE;
+                    else
+                        goto Give_Up;
+                } else if (depth == 0) {
+                    if (c == close_delim)
+                        state = BIX_OUTSIDE;
+                    else if (c == '"')
+                        in_quote = TRUE;
+                    else if (c == '@')
+                        goto Give_Up;
+                }
+                break;
+        }                       /* end switch (state) */
+        column++;
+        continue;
+
+Token_End:
+        if (state == BIX_TYPE) {
+            Integer_T           i;
+
+            for (i = 0; i < token_len; i++)
+                if (token[i] >= 'A' && token[i] <= 'Z')
+                    token[i] += 'a' - 'A';
+            token[token_len] = 0;
+            if (strcmp ((char *) token, "comment") == 0) {
+                state = BIX_OUTSIDE;
+            } else {
+                command = (strcmp ((char *) token, "string") == 0
+                           || strcmp ((char *) token, "preamble") == 0);
+                state = BIX_BEFORE_DELIM;
+            }
+        } else {
+            bix_add_rec (at_offset, at_line, at_column, BIX_ENTRY,
+                         token, token_len);
+            state = BIX_BODY;
+        }
+        if ( ! BIX_IS_EOL (c))
+            goto Reprocess;
+
+Next_Line:
+        /*
+        ** Like eoln(), every CR or LF ends a line.
+        */
+        line_offset = ftell (f);
+        line++;
+        column = 0;
+    }                           /* end for (;;) */
+
+    /*
+    ** If the file ends within an entry, BibTeX complains about it, which
+    ** only a full scan does.
+    */
+    if (state != BIX_OUTSIDE)
+        goto Give_Up;
+    free (token);
+    *size = n;
+    *hash = h;
+    return (TRUE);
+
+Give_Up:
+    free (token);
+    return (FALSE);
+}                               /* bix_build() */
+
+
+
+/*-
+**============================================================================
+** bix_hash_file()
+**
+**  Compute the size and hash of a database file, as bix_build() does.
+**============================================================================
+*/
+static void bix_hash_file (AlphaFile_T f, long *size, BibHash_T *hash)
+{
+    unsigned char       block[8192];
+    size_t              len, i;
+    BibHash_T           h = BIX_HASH_INIT;
+    long                n = 0;
+
+    rewind (f);
+    while ((len = fread (block, 1, sizeof (block), f)) > 0) {
+        for (i = 0; i < len; i++)
+            h = BIX_HASH (h, block[i]);
+        n += (long) len;
+    }
+    *size = n;
+    *hash = h;
+}                               /* bix_hash_file() */
+
+
+
+/*-
+**============================================================================
+** bix_read()
+**
+**  Read an index file and check that it describes a database file with
+**  the given size and hash.
+**============================================================================
+*/
+static Boolean_T bix_read (const char *name, long size, BibHash_T hash)
+{
+    FILE               *fptr;
+    char               *line_buf;
+    int                 line_size;
+    long                ix_size, offset, line, column;
+    BibHash_T           ix_hash;
+    char                kind;
+    int                 key_start, len;
+    Boolean_T           ok = FALSE;
+
+    fptr = fopen (name, FOPEN_R_MODE);
+    if (fptr == NULL)
+        return (FALSE);
+    line_size = Buf_Size + 64;
+    line_buf = (char *) mymalloc ((unsigned long) line_size, "line_buf");
+    bix_num_recs = 0;
+    bix_keys_len = 0;
+    if (fgets (line_buf, line_size, fptr) == NULL
+            || strncmp (line_buf, BIX_HEADER, strlen (BIX_HEADER)) != 0)
+        goto Exit_Label;
+    if (fgets (line_buf, line_size, fptr) == NULL
+            || sscanf (line_buf, "%ld %llx", &ix_size, &ix_hash) != 2
+            || ix_size != size || ix_hash != hash)
+        goto Exit_Label;
+    while (fgets (line_buf, line_size, fptr) != NULL) {
+        len = (int) strlen (line_buf);
+        if (len == 0 || line_buf[len - 1] != '\n')
+            goto Exit_Label;
+        line_buf[--len] = 0;
+        key_start = len;
+        if (sscanf (line_buf, "%ld %ld %ld %c %n", &offset, &line, &column,
+                    &kind, &key_start) < 4)
+            goto Exit_Label;
+        if (kind != BIX_ENTRY && kind != BIX_COMMAND)
+            goto Exit_Label;
+        bix_add_rec (offset, (Integer_T) line, (Integer_T) column, kind,
+                     (unsigned char *) line_buf + key_start,
+                     (kind == BIX_ENTRY) ? len - key_start : 0);
+    }
+    ok = TRUE;
+
+Exit_Label:
+    free (line_buf);
+    fclose (fptr);
+    return (ok);
+}                               /* bix_read() */
+
+
+
+/*-
+**============================================================================
+** bix_write()
+**
+**  Write the in-memory index to an index file.  Failing to do so is not
+**  an error: the database is just scanned again next time.
+**============================================================================
+*/
+static void bix_write (const char *name, long size, BibHash_T hash)
+{
+    FILE               *fptr;
+    Integer_T           i;
+
+#ifdef KPATHSEA
+    if ( ! kpse_out_name_ok (name))
+        return;
+#endif
+    fptr = fopen (name, FOPEN_W_MODE);
+    if (fptr == NULL)
+        return;
+    fprintf (fptr, "%s\n%ld %llx\n", BIX_HEADER, size, hash);
+    for (i = 0; i < bix_num_recs; i++) {
+        BibIndexRec_T      *rec = &bix_recs[i];
+
+        fprintf (fptr, "%ld %ld %ld %c ", rec->offset, (long) rec->line,
+                 (long) rec->column, rec->kind);
+        fwrite (bix_keys + rec->key, 1, rec->key_len, fptr);
+        putc ('\n', fptr);
+    }
+    if (fclose (fptr) != 0)
+        remove (name);
+}                               /* bix_write() */
+
+
+
+/*-
+**============================================================================
+** read_bib_file_indexed()
+**
+**  Read the current database file by way of its index, building the
+**  index first if it's missing or out of date.  Commands are always
+**  processed; an entry is processed only if its key is on the citation
+**  list at that point, which is also the case for entries that are
+**  cross referenced by the entries before them.  Each record is handed
+**  to get_bib_command_or_entry_and_pr() with the line holding its `@'
+**  in the buffer, just as if the file had been read up to there.
+**
+**  Returns FALSE, without having processed anything, if the file can't
+**  be indexed; the caller then reads it in full.
+**============================================================================
+*/
+Boolean_T read_bib_file_indexed (void)
+{
+    AlphaFile_T         f = CUR_BIB_FILE;
+    char               *name;
+    const char         *base;
+    PoolPointer_T       p_ptr;
+    long                size, ix_size;
+    BibHash_T           hash, ix_hash;
+    Integer_T           i, j;
+
+    /*
+    ** The index is named after the database, without its directory.
+    */
+    name = (char *) mymalloc ((unsigned long) LENGTH (CUR_BIB_STR)
+                              + strlen (BIX_EXTENSION) + 1, "bix_name");
+    i = 0;
+    for (p_ptr = str_start[CUR_BIB_STR]; p_ptr < str_start[CUR_BIB_STR + 1];
+         p_ptr++)
+        name[i++] = CHR (str_pool[p_ptr]);
+    name[i] = 0;
+    base = name + strlen (name);
+    while (base > name && ! IS_DIR_SEP (base[-1]))
+        base--;
+    memmove (name, base, strlen (base) + 1);
+    strcat (name, BIX_EXTENSION);
+
+    bix_hash_file (f, &size, &hash);
+    if ( ! bix_read (name, size, hash)) {
+        if ( ! bix_build (f, &ix_size, &ix_hash) || ix_size != size
+                || ix_hash != hash) {
+            debug_msg (DBG_IO, "read_bib_file_indexed: can't index `%s'",
+                       name);
+            free (name);
+            rewind (f);
+            return (FALSE);
+        }
+        bix_write (name, size, hash);
+    }
+    free (name);
+
+    for (i = 0; i < bix_num_recs; i++) {
+        BibIndexRec_T      *rec = &bix_recs[i];
+
+        if (rec->kind == BIX_ENTRY) {
+            for (j = 0; j < rec->key_len; j++)
+                ex_buf[j] = xord[bix_keys[rec->key + j]];
+            lower_case (ex_buf, 0, rec->key_len);
+            (void) str_lookup (ex_buf, 0, rec->key_len, LC_CITE_ILK,
+                               DONT_INSERT);
+            if ( ! hash_found)
+                continue;
+        }
+        if (fseek (f, rec->offset, SEEK_SET) != 0)
+            continue;
+        bib_line_num = rec->line - 1;
+        if ( ! input_ln (f))
+            continue;
+        INCR (bib_line_num);
+        buf_ptr2 = rec->column;
+        get_bib_command_or_entry_and_pr ();
+    }
+    return (TRUE);
+}                               /* read_bib_file_indexed() */
+
+
+
 /*-
 ******************************************************************************
 ******************************************************************************
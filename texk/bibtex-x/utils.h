@@ -118,6 +118,7 @@ void                   *mymalloc (const unsigned long bytes_required,
 void                   *myrealloc (void *old_ptr, const unsigned long bytes_required,
 				const char *var_name);
 void                    parse_cmd_line (int argc, char **argv);
+Boolean_T               read_bib_file_indexed (void);
 void                    report_bibtex_capacity (void);
 void                    report_search_paths (void);
 void		        set_array_sizes (void);
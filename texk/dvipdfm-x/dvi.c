@@ -35,6 +35,9 @@
 #ifdef WIN32
 #include <fcntl.h>
 #include <io.h>
+#else
+#include <sys/stat.h>
+#include <sys/mman.h>
 #endif
 
 #include "system.h"
@@ -89,6 +92,14 @@ static unsigned int num_pages = 0;
 
 static uint32_t dvi_file_size = 0;
 
+/* When the DVI file is a regular file it is mapped into memory, and
+ * pages are decoded in place: dvi_page_buffer then points into the
+ * mapping and selecting a page costs nothing.  Linear input (a pipe)
+ * and pages carrying fnt_defs are copied into dvi_page_store instead.
+ */
+static const unsigned char *dvi_map = NULL;
+static size_t               dvi_map_size = 0;
+
 static struct dvi_header
 {
   uint32_t unit_num;
@@ -227,7 +238,8 @@ static double phantom_depth  = 0.0;
 
 #define DVI_PAGE_BUF_CHUNK              0x10000U        /* 64K should be plenty for most pages */
 
-static unsigned char* dvi_page_buffer;
+static const unsigned char *dvi_page_buffer;
+static unsigned char *dvi_page_store;
 static unsigned int   dvi_page_buf_size;
 static unsigned int   dvi_page_buf_index;
 
@@ -239,9 +251,9 @@ static int get_and_buffer_unsigned_byte (FILE *file)
     ERROR ("File ended prematurely\n");
   if (dvi_page_buf_index >= dvi_page_buf_size) {
     dvi_page_buf_size += DVI_PAGE_BUF_CHUNK;
-    dvi_page_buffer = RENEW(dvi_page_buffer, dvi_page_buf_size, unsigned char);
+    dvi_page_store = RENEW(dvi_page_store, dvi_page_buf_size, unsigned char);
   }
-  dvi_page_buffer[dvi_page_buf_index++] = ch;
+  dvi_page_store[dvi_page_buf_index++] = ch;
   return ch;
 }
 
@@ -256,13 +268,23 @@ static void get_and_buffer_bytes(FILE *file, unsigned int count)
 {
   if (dvi_page_buf_index + count >= dvi_page_buf_size) {
     dvi_page_buf_size = dvi_page_buf_index + count + DVI_PAGE_BUF_CHUNK;
-    dvi_page_buffer = RENEW(dvi_page_buffer, dvi_page_buf_size, unsigned char);
+    dvi_page_store = RENEW(dvi_page_store, dvi_page_buf_size, unsigned char);
   }
-  if (fread(dvi_page_buffer + dvi_page_buf_index, 1, count, file) != count)
+  if (fread(dvi_page_store + dvi_page_buf_index, 1, count, file) != count)
     ERROR ("File ended prematurely\n");
   dvi_page_buf_index += count;
 }
 
+static void append_to_buffer(const unsigned char *p, size_t count)
+{
+  if (dvi_page_buf_index + count >= dvi_page_buf_size) {
+    dvi_page_buf_size = dvi_page_buf_index + count + DVI_PAGE_BUF_CHUNK;
+    dvi_page_store = RENEW(dvi_page_store, dvi_page_buf_size, unsigned char);
+  }
+  memcpy(dvi_page_store + dvi_page_buf_index, p, count);
+  dvi_page_buf_index += count;
+}
+
 /* functions to fetch values from dvi_page_buffer */
 
 static int get_buffered_unsigned_byte (void)
@@ -355,6 +377,25 @@ need_pTeX (int c) {
   has_ptex = 1;
 }
 
+static void
+map_dvi_file (void)
+{
+#ifndef WIN32
+  struct stat sb;
+  void       *p;
+
+  if (fstat(fileno(dvi_file), &sb) != 0 || !S_ISREG(sb.st_mode) ||
+      sb.st_size <= 0 || (off_t) (size_t) sb.st_size != sb.st_size)
+    return;
+  p = mmap(NULL, (size_t) sb.st_size, PROT_READ, MAP_PRIVATE,
+           fileno(dvi_file), 0);
+  if (p == MAP_FAILED)
+    return;
+  dvi_map      = p;
+  dvi_map_size = (size_t) sb.st_size;
+#endif
+}
+
 static int32_t
 find_post (void)
 {
@@ -2370,6 +2411,7 @@ dvi_init (char *dvi_filename, double mag)
     /* DVI files are most easily read backwards by
      * searching for post_post and then post opcode.
      */
+    map_dvi_file();
     post_location = find_post();
     get_dvi_info(post_location);
     do_scales(mag);
@@ -2380,7 +2422,8 @@ dvi_init (char *dvi_filename, double mag)
   clear_state();
 
   dvi_page_buf_size = DVI_PAGE_BUF_CHUNK;
-  dvi_page_buffer = NEW(dvi_page_buf_size, unsigned char);
+  dvi_page_store = NEW(dvi_page_buf_size, unsigned char);
+  dvi_page_buffer = dvi_page_store;
 
   return dvi2pts;
 }
@@ -2402,6 +2445,12 @@ dvi_close (void)
    */
 
   /* Do some house cleaning */
+#ifndef WIN32
+  if (dvi_map)
+    munmap((void *) dvi_map, dvi_map_size);
+#endif
+  dvi_map = NULL;
+  dvi_map_size = 0;
   MFCLOSE(dvi_file);
   dvi_file = NULL;
 
@@ -2436,11 +2485,12 @@ dvi_close (void)
   vf_close_all_fonts();
   tfm_close_all ();
   
-  if (dvi_page_buffer) {
-    RELEASE(dvi_page_buffer);
-    dvi_page_buffer = NULL;
+  if (dvi_page_store) {
+    RELEASE(dvi_page_store);
+    dvi_page_store = NULL;
     dvi_page_buf_size = 0;
   }
+  dvi_page_buffer = NULL;
 }
 
 /* The following are need to implement virtual fonts
@@ -2740,6 +2790,156 @@ scan_special (double *wd, double *ht, double *xo, double *yo, int *lm,
 }
 
 
+/* dvi_scan_specials() for a mapped DVI file.  The page is used where
+ * it lies unless it contains font definitions; those are dropped while
+ * copying the rest of the page into dvi_page_store, as in the stdio
+ * case.
+ */
+static void
+scan_mapped_page (int32_t offset,
+                  double *page_width, double *page_height,
+                  double *x_offset, double *y_offset, int *landscape,
+                  int *majorversion, int *minorversion,
+                  int *do_enc, int *key_bits, int32_t *permission,
+                  char *owner_pw, char *user_pw,
+                  int *has_id, unsigned char *id1, unsigned char *id2)
+{
+  const unsigned char *p, *start, *endptr;
+  unsigned char        opcode;
+  uint32_t             size, len;
+  unsigned int         flags;
+  int                  copied = 0;
+
+  if (offset < 0 || (size_t) offset >= dvi_map_size)
+    ERROR("Invalid page location: %d", offset);
+  p = start = dvi_map + offset;
+  endptr    = dvi_map + dvi_map_size;
+
+#define need(n) if ((size_t) (endptr - p) < (size_t) (n)) \
+    ERROR("File ended prematurely\n")
+#define pair(q) (((unsigned int) (q)[0] << 8) | (q)[1])
+  for (;;) {
+    need(1);
+    opcode = *p++;
+    if (opcode == EOP)
+      break;
+    if (opcode <= SET_CHAR_127 ||
+        (opcode >= FNT_NUM_0 && opcode <= FNT_NUM_63))
+      continue;
+
+    switch (opcode) {
+    case XXX1: case XXX2: case XXX3: case XXX4:
+      len = opcode - XXX1 + 1;
+      need(len);
+      for (size = 0; len > 0; len--)
+        size = size * 0x100u + *p++;
+      if (size > 0x7fffffffu)
+        WARN("Unsigned number starting with %x exceeds 0x7fffffff", size >> 16);
+      need(size);
+      if (scan_special(page_width, page_height, x_offset, y_offset, landscape,
+                       majorversion, minorversion,
+                       do_enc, key_bits, permission, owner_pw, user_pw,
+                       has_id, id1, id2,
+                       (const char *) p, size))
+        WARN("Reading special command failed: \"%.*s\"", size, p);
+      len = size;
+      break;
+    case FNT_DEF1: case FNT_DEF2: case FNT_DEF3: case FNT_DEF4:
+      append_to_buffer(start, p - 1 - start);
+      copied = 1;
+      len = opcode - FNT_DEF1 + 1 + 12;  /* k[1..4], c[4], s[4], d[4] */
+      need(len + 2);
+      len += 2 + p[len] + p[len + 1];    /* a[1], l[1], n[a+l] */
+      need(len);
+      p += len;
+      start = p;
+      continue;
+    case XDV_NATIVE_FONT_DEF:
+      need_XeTeX(opcode);
+      append_to_buffer(start, p - 1 - start);
+      copied = 1;
+      need(11);                          /* id, size, flags, name length */
+      flags = pair(p + 8);
+      len = 11 + p[10] + 4;              /* name, face index */
+      if (flags & XDV_FLAG_COLORED)
+        len += 4;
+      if (flags & XDV_FLAG_EXTEND)
+        len += 4;
+      if (flags & XDV_FLAG_SLANT)
+        len += 4;
+      if (flags & XDV_FLAG_EMBOLDEN)
+        len += 4;
+      need(len);
+      p += len;
+      start = p;
+      continue;
+    case BOP:
+      len = 44;
+      break;
+    case NOP: case PUSH: case POP:
+    case W0: case X0: case Y0: case Z0:
+      len = 0;
+      break;
+    case SET1: case PUT1: case RIGHT1:  case DOWN1:
+    case W1: case X1: case Y1: case Z1: case FNT1:
+      len = 1;
+      break;
+    case SET2: case PUT2: case RIGHT2: case DOWN2:
+    case W2: case X2: case Y2: case Z2: case FNT2:
+      len = 2;
+      break;
+    case SET3: case PUT3: case RIGHT3: case DOWN3:
+    case W3: case X3: case Y3: case Z3: case FNT3:
+      len = 3;
+      break;
+    case SET4: case PUT4: case RIGHT4: case DOWN4:
+    case W4: case X4: case Y4: case Z4: case FNT4:
+      len = 4;
+      break;
+    case SET_RULE: case PUT_RULE:
+      len = 8;
+      break;
+    case XDV_GLYPHS:
+      need_XeTeX(opcode);
+      need(6);                           /* width, glyph count */
+      len = 6 + pair(p + 4) * 10;
+      break;
+    case XDV_TEXT_AND_GLYPHS:
+      need_XeTeX(opcode);
+      need(2);                           /* utf16 code unit count */
+      len = 2 + pair(p) * 2 + 4;
+      need(len + 2);                     /* glyph count */
+      len += 2 + pair(p + len) * 10;
+      break;
+    case BEGIN_REFLECT:
+    case END_REFLECT:
+      need_XeTeX(opcode);
+      len = 0;
+      break;
+    case PTEXDIR:
+      need_pTeX(opcode);
+      len = 1;
+      break;
+    default: /* case PRE: case POST: case POST_POST: and others */
+      ERROR("Unexpected opcode %d at pos=0x%x", opcode,
+            (unsigned int) (p - 1 - dvi_map));
+      len = 0;
+      break;
+    }
+    need(len);
+    p += len;
+  }
+#undef pair
+#undef need
+
+  if (copied) {
+    append_to_buffer(start, p - start);
+    dvi_page_buffer = dvi_page_store;
+  } else {
+    dvi_page_buffer = start;
+  }
+}
+
 void
 dvi_scan_specials (int page_no,
                    double *page_width, double *page_height,
@@ -2760,12 +2960,21 @@ dvi_scan_specials (int page_no,
   buffered_page = page_no;
 
   dvi_page_buf_index = 0;
+  dvi_page_buffer = dvi_page_store;
 
   if (!linear) {
     if (page_no >= num_pages)
       ERROR("Invalid page number: %u", page_no);
     offset = page_loc[page_no];
 
+    if (dvi_map) {
+      scan_mapped_page(offset,
+                       page_width, page_height, x_offset, y_offset, landscape,
+                       majorversion, minorversion,
+                       do_enc, key_bits, permission, owner_pw, user_pw,
+                       has_id, id1, id2);
+      return;
+    }
     xseek_absolute (fp, offset, "DVI");
   }
   
@@ -2786,9 +2995,9 @@ dvi_scan_specials (int page_no,
       }
       if (dvi_page_buf_index + size >= dvi_page_buf_size) {
         dvi_page_buf_size = (dvi_page_buf_index + size + DVI_PAGE_BUF_CHUNK);
-        dvi_page_buffer = RENEW(dvi_page_buffer, dvi_page_buf_size, unsigned char);
+        dvi_page_store = RENEW(dvi_page_store, dvi_page_buf_size, unsigned char);
       }
-#define buf ((char*)(dvi_page_buffer + dvi_page_buf_index))
+#define buf ((char*)(dvi_page_store + dvi_page_buf_index))
       if (fread(buf, sizeof(char), size, fp) != size)
         ERROR("Reading DVI file failed!");
       if (scan_special(page_width, page_height, x_offset, y_offset, landscape,
@@ -2876,6 +3085,7 @@ dvi_scan_specials (int page_no,
       break;
     }
   }
+  dvi_page_buffer = dvi_page_store;
 
   return;
 }
@@ -34,6 +34,8 @@
 #include "error.h"
 #include "mfileio.h"
 #include "dpxconf.h"
+#include "dpxcrypt.h"
+#include "dpxutil.h"
 
 #include "numbers.h"
 
@@ -116,6 +118,10 @@ struct form_list_node
   int      q_depth;
   pdf_form form;
 
+  /* Shared content: the XObject is only defined when grabbing ends. */
+  int        shared;
+  xform_info info;
+
   struct form_list_node *prev;
 };
 
@@ -227,6 +233,8 @@ typedef struct pdf_doc
   } options;
 
   struct form_list_node *pending_forms;
+  /* Shared content Form XObjects keyed by MD5 digest of their content. */
+  struct ht_table shared_forms;
 
   char *thumb_basename;
 } pdf_doc;
@@ -359,6 +367,8 @@ static void pdf_doc_close_names (pdf_doc *p);
 
 static void pdf_doc_add_goto (pdf_obj *annot_dict);
 
+static void release_shared_form (void *data);
+
 static void pdf_doc_init_docinfo  (pdf_doc *p);
 static void pdf_doc_close_docinfo (pdf_doc *p);
 
@@ -2548,6 +2558,7 @@ pdf_open_document (const char *filename,
   }
 
   p->pending_forms = NULL;
+  ht_init_table(&p->shared_forms, release_shared_form);
 
   pdf_init_device(settings.device.dvi2pts, settings.device.precision,
                   settings.device.ignore_colors);
@@ -2578,6 +2589,8 @@ pdf_close_document (void)
 
   pdf_doc_close_catalog  (p);
 
+  ht_clear_table(&p->shared_forms);
+
   pdf_close_images();
   pdf_close_fonts ();
   pdf_close_colors();
@@ -2650,15 +2663,13 @@ pdf_doc_make_xform (pdf_obj     *xform,
  * xpos and ypos that is clipped to the specified bbox. Note
  * that the origin is not the lower left corner of the bbox.
  */
-int
-pdf_doc_begin_grabbing (const char *ident,
-                        double ref_x, double ref_y, const pdf_rect *cropbox)
+static struct form_list_node *
+pdf_doc_push_form (double ref_x, double ref_y, const pdf_rect *cropbox)
 {
-  int         xobj_id = -1;
   pdf_doc    *p = &pdoc;
   pdf_form   *form;
   struct form_list_node *fnode;
-  xform_info  info;
+  xform_info *info;
 
   pdf_dev_push_gstate();
 
@@ -2666,6 +2677,7 @@ pdf_doc_begin_grabbing (const char *ident,
 
   fnode->prev    = p->pending_forms;
   fnode->q_depth = pdf_dev_current_depth();
+  fnode->shared  = 0;
   form           = &fnode->form;
 
   /*
@@ -2688,24 +2700,26 @@ pdf_doc_begin_grabbing (const char *ident,
   form->contents  = pdf_new_stream(STREAM_COMPRESS);
   form->resources = pdf_new_dict();
 
-  pdf_ximage_init_form_info(&info);
+  info = &fnode->info;
+  pdf_ximage_init_form_info(info);
 
-  info.matrix.a = 1.0; info.matrix.b = 0.0;
-  info.matrix.c = 0.0; info.matrix.d = 1.0;
-  info.matrix.e = -ref_x;
-  info.matrix.f = -ref_y;
+  info->matrix.a = 1.0; info->matrix.b = 0.0;
+  info->matrix.c = 0.0; info->matrix.d = 1.0;
+  info->matrix.e = -ref_x;
+  info->matrix.f = -ref_y;
 
-  info.bbox.llx = cropbox->llx;
-  info.bbox.lly = cropbox->lly;
-  info.bbox.urx = cropbox->urx;
-  info.bbox.ury = cropbox->ury;
+  info->bbox.llx = cropbox->llx;
+  info->bbox.lly = cropbox->lly;
+  info->bbox.urx = cropbox->urx;
+  info->bbox.ury = cropbox->ury;
 
-  /* Use reference since content itself isn't available yet.
-   * - 2020/07/21 Changed... "forward reference" support requires object itself.
-   */
-  xobj_id = pdf_ximage_defineresource(ident,
-                                      PDF_XOBJECT_TYPE_FORM,
-                                      &info, pdf_link_obj(form->contents));
+  return fnode;
+}
+
+static void
+pdf_doc_start_form (struct form_list_node *fnode)
+{
+  pdf_doc *p = &pdoc;
 
   p->pending_forms = fnode;
 
@@ -2716,21 +2730,128 @@ pdf_doc_begin_grabbing (const char *ident,
   pdf_dev_reset_fonts(1);
   pdf_dev_reset_color(1);  /* force color operators to be added to stream */
   pdf_dev_reset_xgstate(1);
+}
+
+int
+pdf_doc_begin_grabbing (const char *ident,
+                        double ref_x, double ref_y, const pdf_rect *cropbox)
+{
+  int         xobj_id = -1;
+  pdf_form   *form;
+  struct form_list_node *fnode;
+
+  fnode = pdf_doc_push_form(ref_x, ref_y, cropbox);
+  form  = &fnode->form;
+
+  /* Use reference since content itself isn't available yet.
+   * - 2020/07/21 Changed... "forward reference" support requires object itself.
+   */
+  xobj_id = pdf_ximage_defineresource(ident,
+                                      PDF_XOBJECT_TYPE_FORM,
+                                      &fnode->info, pdf_link_obj(form->contents));
+
+  pdf_doc_start_form(fnode);
 
   return xobj_id;
 }
 
-void
-pdf_doc_end_grabbing (pdf_obj *attrib)
+/*
+ * Shared content is grabbed like an anonymous form but the XObject is
+ * defined only after the content is complete: identical content seen
+ * before (e.g., running headers and footers, page decoration) is
+ * discarded and the previously defined XObject is reused instead.
+ */
+int
+pdf_doc_begin_shared (double ref_x, double ref_y, const pdf_rect *cropbox)
+{
+  struct form_list_node *fnode;
+  pdf_rect mediabox;
+
+  /* Whole page if no bounding box is given. */
+  if (!cropbox) {
+    pdf_doc_get_mediabox(pdf_doc_current_page_number(), &mediabox);
+    mediabox.llx -= ref_x; mediabox.lly -= ref_y;
+    mediabox.urx -= ref_x; mediabox.ury -= ref_y;
+    cropbox = &mediabox;
+  }
+
+  fnode = pdf_doc_push_form(ref_x, ref_y, cropbox);
+  fnode->shared = 1;
+
+  pdf_doc_start_form(fnode);
+
+  return 0;
+}
+
+struct shared_form
 {
+  int      xobj_id;
+  pdf_obj *resources;
+};
+
+static void
+release_shared_form (void *data)
+{
+  struct shared_form *sf = data;
+
+  if (sf) {
+    pdf_release_obj(sf->resources);
+    RELEASE(sf);
+  }
+}
+
+static void
+digest_number (MD5_CONTEXT *md5, double value)
+{
+  char buf[32];
+  int  len;
+
+  len = sprintf(buf, "%.3f ", ROUND(value, .001));
+  MD5_write(md5, (unsigned char *) buf, len);
+}
+
+/* Returns xobj_id of a previously defined XObject having the same
+ * content as the pending shared form, or -1 if there isn't any.
+ */
+static int
+lookup_shared_form (struct form_list_node *fnode, unsigned char *digest)
+{
+  pdf_doc  *p = &pdoc;
+  pdf_form *form = &fnode->form;
+  MD5_CONTEXT md5;
+  struct shared_form *sf;
+
+  MD5_init(&md5);
+  digest_number(&md5, form->cropbox.llx);
+  digest_number(&md5, form->cropbox.lly);
+  digest_number(&md5, form->cropbox.urx);
+  digest_number(&md5, form->cropbox.ury);
+  digest_number(&md5, form->matrix.e);
+  digest_number(&md5, form->matrix.f);
+  MD5_write(&md5, (const unsigned char *) pdf_stream_dataptr(form->contents),
+            pdf_stream_length(form->contents));
+  MD5_final(digest, &md5);
+
+  sf = ht_lookup_table(&p->shared_forms, digest, 16);
+  if (sf && !pdf_compare_object(sf->resources, form->resources))
+    return sf->xobj_id;
+
+  return -1;
+}
+
+static int
+pdf_doc_finish_form (pdf_obj *attrib)
+{
+  int       xobj_id = -1;
   pdf_form *form;
   pdf_obj  *procset;
   pdf_doc  *p = &pdoc;
   struct form_list_node *fnode;
+  unsigned char digest[16];
 
   if (!p->pending_forms) {
     WARN("Tried to close a nonexistent form XOject.");
-    return;
+    return -1;
   }
   
   fnode = p->pending_forms;
@@ -2749,12 +2870,36 @@ pdf_doc_end_grabbing (pdf_obj *attrib)
   pdf_add_array(procset, pdf_new_name("ImageI"));
   pdf_add_dict (form->resources, pdf_new_name("ProcSet"), procset);
 
-  pdf_doc_make_xform(form->contents,
-                     &form->cropbox, &form->matrix,
-                     pdf_ref_obj(form->resources), attrib);
-  pdf_release_obj(form->resources);
-  pdf_release_obj(form->contents);
-  if (attrib) pdf_release_obj(attrib);
+  if (fnode->shared) {
+    xobj_id = lookup_shared_form(fnode, digest);
+    if (xobj_id >= 0) {
+      /* Never referenced: just discarded without being written. */
+      pdf_release_obj(form->resources);
+      pdf_release_obj(form->contents);
+      if (attrib) pdf_release_obj(attrib);
+    }
+  }
+
+  if (xobj_id < 0) {
+    if (fnode->shared) {
+      struct shared_form *sf;
+
+      xobj_id = pdf_ximage_defineresource(NULL,
+                                          PDF_XOBJECT_TYPE_FORM,
+                                          &fnode->info, pdf_link_obj(form->contents));
+      sf = NEW(1, struct shared_form);
+      sf->xobj_id   = xobj_id;
+      sf->resources = pdf_link_obj(form->resources);
+      ht_insert_table(&p->shared_forms, digest, 16, sf);
+    }
+
+    pdf_doc_make_xform(form->contents,
+                       &form->cropbox, &form->matrix,
+                       pdf_ref_obj(form->resources), attrib);
+    pdf_release_obj(form->resources);
+    pdf_release_obj(form->contents);
+    if (attrib) pdf_release_obj(attrib);
+  }
 
   p->pending_forms = fnode->prev;
 
@@ -2766,7 +2911,27 @@ pdf_doc_end_grabbing (pdf_obj *attrib)
 
   RELEASE(fnode);
 
-  return;
+  return xobj_id;
+}
+
+void
+pdf_doc_end_grabbing (pdf_obj *attrib)
+{
+  pdf_doc_finish_form(attrib);
+}
+
+/* Returns xobj_id of the (possibly reused) shared form XObject. */
+int
+pdf_doc_end_shared (void)
+{
+  pdf_doc *p = &pdoc;
+
+  if (p->pending_forms && !p->pending_forms->shared) {
+    WARN("Shared content ended inside of a form XObject.");
+    return -1;
+  }
+
+  return pdf_doc_finish_form(NULL);
 }
 
 static struct
@@ -142,6 +142,14 @@ extern int pdf_doc_begin_grabbing(const char *ident,
                                   const pdf_rect *cropbox);
 extern void pdf_doc_end_grabbing(pdf_obj *attrib);
 
+/* Shared content: identical content is placed as one form XObject.
+ * The whole page is grabbed if cropbox is NULL.
+ * pdf_doc_end_shared() returns xobj_id of the (possibly reused) XObject.
+ */
+extern int pdf_doc_begin_shared(double ref_x, double ref_y,
+                                const pdf_rect *cropbox);
+extern int pdf_doc_end_shared(void);
+
 /* Annotation */
 extern void pdf_doc_add_annot(unsigned page_no,
                               const pdf_rect *rect,
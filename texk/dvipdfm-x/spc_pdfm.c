@@ -71,13 +71,15 @@ struct spc_pdf_
    int               lowest_level; /* current min level of outlines */
    struct tounicode  cd;           /* For to-UTF16-BE conversion :( */
    pdf_obj          *pageresources; /* Add to all page resource dict */
+   dpx_stack         shared;        /* Reference points of bshare    */
 };
 
 static struct spc_pdf_  _pdf_stat = {
   NULL,
   255,
   { -1, 0, NULL },
-  NULL
+  NULL,
+  { 0, NULL, NULL }
 };
 
 static pdf_obj *
@@ -124,6 +126,7 @@ spc_handler_pdfm__init (void *dp)
 		  pdf_new_name(default_taintkeys[i]));
   }
   sd->pageresources = NULL;
+  dpx_stack_init(&sd->shared);
 
   return 0;
 }
@@ -145,6 +148,13 @@ spc_handler_pdfm__clean (void *dp)
   if (sd->pageresources)
     pdf_release_obj(sd->pageresources);
   sd->pageresources = NULL;
+  if (dpx_stack_depth(&sd->shared) > 0) {
+    pdf_coord *cp;
+
+    WARN("Unbalanced bshare and eshare found.");
+    while ((cp = dpx_stack_pop(&sd->shared)) != NULL)
+      RELEASE(cp);
+  }
 
   return 0;
 }
@@ -1941,6 +1951,97 @@ spc_handler_pdfm_uxobj (struct spc_env *spe, struct spc_arg *args)
   return 0;
 }
 
+/* Shared content is grabbed and placed in the same place:
+ *
+ * \special{pdf:bshare [width WD height HT depth DP | bbox LLX LLY URX URY]}
+ *   ... page decoration ...
+ * \special{pdf:eshare}
+ *
+ * The content is put into a form XObject and byte-identical content
+ * found later, e.g., running headers, footers and logos repeated on
+ * every page, reuses the same XObject instead of being written again.
+ * The whole page is assumed when no dimension is given.
+ */
+static int
+spc_handler_pdfm_bshare (struct spc_env *spe, struct spc_arg *args)
+{
+  int              error;
+  pdf_rect         cropbox;
+  pdf_coord        cp, *ref;
+  transform_info   ti;
+  struct spc_pdf_ *sd = &_pdf_stat;
+
+  skip_white(&args->curptr, args->endptr);
+
+  transform_info_clear(&ti);
+  if (args->curptr < args->endptr) {
+    if (spc_util_read_dimtrns(spe, &ti, args, 0) < 0)
+      return  -1;
+  }
+
+  spc_get_current_point(spe, &cp);
+  if (ti.flags & INFO_HAS_USER_BBOX) {
+    cropbox.llx = ti.bbox.llx;
+    cropbox.lly = ti.bbox.lly;
+    cropbox.urx = ti.bbox.urx;
+    cropbox.ury = ti.bbox.ury;
+  } else {
+    cropbox.llx = 0.0;
+    cropbox.lly = -ti.depth;
+    cropbox.urx = ti.width;
+    cropbox.ury = ti.height;
+  }
+  if ((ti.flags & INFO_HAS_USER_BBOX) ||
+      ti.width != 0.0 || ti.depth + ti.height != 0.0) {
+    if (cropbox.urx - cropbox.llx == 0.0 ||
+        cropbox.ury - cropbox.lly == 0.0) {
+      spc_warn(spe, "Bounding box has a zero dimension.");
+      return -1;
+    }
+    error = spc_begin_shared(spe, cp, &cropbox);
+  } else {
+    error = spc_begin_shared(spe, cp, NULL);
+  }
+  if (error) {
+    spc_warn(spe, "Couldn't start shared content.");
+  } else {
+    ref    = NEW(1, pdf_coord);
+    ref->x = spe->x_user;
+    ref->y = spe->y_user;
+    dpx_stack_push(&sd->shared, ref);
+  }
+
+  return error;
+}
+
+static int
+spc_handler_pdfm_eshare (struct spc_env *spe, struct spc_arg *args)
+{
+  int              xobj_id;
+  pdf_coord       *ref;
+  transform_info   ti;
+  struct spc_pdf_ *sd = &_pdf_stat;
+
+  ref = dpx_stack_pop(&sd->shared);
+  if (!ref) {
+    spc_warn(spe, "Tried to close a nonexistent shared content.");
+    return -1;
+  }
+
+  /* pageresources here too */
+  if (sd->pageresources) {
+    pdf_foreach_dict(sd->pageresources, forallresourcecategory, NULL);
+  }
+  xobj_id = spc_end_shared(spe);
+  if (xobj_id >= 0) {
+    transform_info_clear(&ti);
+    spc_put_image(spe, xobj_id, &ti, ref->x, ref->y);
+  }
+  RELEASE(ref);
+
+  return xobj_id < 0 ? -1 : 0;
+}
+
 static int
 spc_handler_pdfm_link (struct spc_env *spe, struct spc_arg *args)
 {
@@ -2334,6 +2435,8 @@ static struct spc_handler pdfm_handlers[] = {
 
   {"bcontent",   spc_handler_pdfm_bcontent},
   {"econtent",   spc_handler_pdfm_econtent},
+  {"bshare",     spc_handler_pdfm_bshare},
+  {"eshare",     spc_handler_pdfm_eshare},
   {"code",       spc_handler_pdfm_code},
 
   {"minorversion", spc_handler_pdfm_do_nothing},
@@ -663,6 +663,43 @@ spc_end_form (struct spc_env *spe, pdf_obj *attr)
   return error;
 }
 
+int
+spc_begin_shared (struct spc_env *spe, pdf_coord cp, pdf_rect *cropbox)
+{
+  int  error = 0;
+  int  i;
+
+  error = pdf_doc_begin_shared(cp.x, cp.y, cropbox);
+
+  if (!error) {
+    for (i = 0; known_specials[i].key != NULL; i++) {
+      if (known_specials[i].bofhk_func) {
+        error = known_specials[i].bofhk_func();
+      }
+    }
+  }
+
+  return error;
+}
+
+/* Returns xobj_id of the shared form. */
+int
+spc_end_shared (struct spc_env *spe)
+{
+  int  xobj_id;
+  int  i;
+
+  xobj_id = pdf_doc_end_shared();
+
+  for (i = 0; known_specials[i].key != NULL; i++) {
+    if (known_specials[i].eofhk_func) {
+      known_specials[i].eofhk_func();
+    }
+  }
+
+  return xobj_id;
+}
+
 int
 spc_exec_at_begin_page (void)
 {
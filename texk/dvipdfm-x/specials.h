@@ -65,6 +65,8 @@ extern int      spc_suspend_annot (struct spc_env *spe);
 
 extern int      spc_begin_form    (struct spc_env *spe, const char *ident, pdf_coord cp, pdf_rect *cropbox);
 extern int      spc_end_form      (struct spc_env *spe, pdf_obj *attr);
+extern int      spc_begin_shared  (struct spc_env *spe, pdf_coord cp, pdf_rect *cropbox);
+extern int      spc_end_shared    (struct spc_env *spe);
 
 extern int      spc_is_tracking_boxes (struct spc_env *spe);
 
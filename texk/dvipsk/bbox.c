@@ -474,7 +474,7 @@ case 242: bbspecial(h, v, dir, (int)signedquad()); break;
 void
 findbb(integer bop)
 {
-   integer curpos = ftell(dvifile);
+   integer curpos = dvitell();
    real conv = 72.0 * (real)num / (real)den * (real)mag / 254000000.0;
    real off = 72.0 / conv;
    real margin = 1.0 / conv;
@@ -482,9 +482,9 @@ findbb(integer bop)
    real hadj = -72.0 * hoff / 4736286.72;
    real vadj = 72.0 * voff / 4736286.72;
 
-   fseek(dvifile, bop, 0);
+   dviseek(bop);
    bbdopage();
-   fseek(dvifile, curpos, 0);
+   dviseek(curpos);
    lly = (int) (vsize - 2 * off - lly);
    ury = (int) (vsize - 2 * off - ury);
    llx = (int)floor((llx + off - margin) * conv - hadj + 0.5);
@@ -0,0 +1,107 @@
+#!/usr/bin/env perl
+# $Id$
+# Public domain.
+# Measure dvips PostScript output throughput when writing to a pipe.
+#
+# Usage: bench-output.pl [-pages N] [-runs N] [-dvips PROG] [FILE.dvi]
+#
+# Without FILE.dvi, a synthetic document of N (default 500) dense pages
+# of cmr10 text and rules is generated, which exercises the positioning
+# and string code in output.c.  This is not part of `make check', since
+# timings are meaningless there; run it by hand from the build
+# directory, e.g.  perl $srcdir/bench-output.pl -pages 2000
+
+use strict;
+use warnings;
+use Time::HiRes qw(time);
+
+my $pages = 500;
+my $runs = 3;
+my $dvips = "./dvips";
+my $dvi;
+
+while (@ARGV) {
+  my $a = shift @ARGV;
+  if ($a eq "-pages") { $pages = shift @ARGV; }
+  elsif ($a eq "-runs") { $runs = shift @ARGV; }
+  elsif ($a eq "-dvips") { $dvips = shift @ARGV; }
+  elsif ($a =~ /^-/) { die "$0: unknown option $a\n"; }
+  else { $dvi = $a; }
+}
+
+my $srcdir = $ENV{"srcdir"};
+if (! defined $srcdir) {
+  chomp ($srcdir = `dirname $0`);
+}
+$ENV{"TEXMFCNF"} ||= "$srcdir/../kpathsea";
+for my $v (qw(TEXCONFIG TEXFONTS TEXFONTMAPS TEXPSHEADERS)) {
+  $ENV{$v} ||= "$srcdir/testdata";
+}
+
+if (! defined $dvi) {
+  $dvi = "bench-output.dvi";
+  &make_dvi ($dvi, $pages);
+}
+
+my ($best, $bytes);
+for my $run (1 .. $runs) {
+  my $t0 = time ();
+  open (my $ps, "-|", $dvips, "-q", "-f", $dvi)
+    || die "$0: cannot run $dvips: $!\n";
+  binmode ($ps);
+  my ($n, $buf) = (0, "");
+  while (my $got = read ($ps, $buf, 65536)) {
+    $n += $got;
+  }
+  close ($ps) || die "$0: $dvips failed (status $?)\n";
+  my $dt = time () - $t0;
+  $best = $dt if ! defined $best || $dt < $best;
+  $bytes = $n;
+  printf "run %d: %d bytes in %.3f s, %.1f MB/s\n",
+         $run, $n, $dt, $n / $dt / 1e6;
+}
+printf "best: %.1f MB/s\n", $bytes / $best / 1e6;
+exit 0;
+
+# Write a DVI file of $npages pages, each with 60 lines of cmr10 text
+# interleaved with small kerns and rules.
+sub make_dvi
+{
+  my ($file, $npages) = @_;
+  my $fntdef = pack ("CCNNNCCa*", 243, 0, 0, 655360, 655360, 0, 5, "cmr10");
+  my $out = pack ("CCNNNC", 247, 2, 25400000, 473628672, 1000, 0);
+  my $prev = -1;
+  my @words = qw(the quick brown fox jumps over lazy dog while
+                 (parenthesized) text and 100% escapes flow past);
+
+  for my $p (1 .. $npages) {
+    my $bop = length ($out);
+    $out .= pack ("CN10l>", 139, $p, (0) x 9, $prev);
+    $out .= $fntdef if $p == 1;
+    $out .= pack ("C", 171);
+    for my $line (0 .. 59) {
+      $out .= pack ("C", 141);                   # push
+      $out .= pack ("Cl>", 160, 65536 * 12 * $line);  # down4
+      for my $w (0 .. 9) {
+        my $word = $words[($p + $line + $w) % @words];
+        $out .= pack ("C", ord $_) for split //, $word;
+        $out .= pack ("Cl>", 146, 65536 * 3 + $w * 977);  # right4
+      }
+      $out .= pack ("Cl>l>", 137, 26214, 65536 * 20) if $line % 4 == 0;
+      $out .= pack ("C", 142);                   # pop
+    }
+    $out .= pack ("C", 140);
+    $prev = $bop;
+  }
+  my $post = length ($out);
+  $out .= pack ("Cl>NNNNNnn", 248, $prev, 25400000, 473628672, 1000,
+                65536 * 800, 65536 * 600, 2, $npages);
+  $out .= $fntdef;
+  $out .= pack ("CNC", 249, $post, 2) . "\337" x 4;
+  $out .= "\337" while length ($out) % 4;
+
+  open (my $fh, ">", $file) || die "$0: cannot write $file: $!\n";
+  binmode ($fh);
+  print $fh $out;
+  close ($fh);
+}
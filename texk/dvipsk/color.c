@@ -208,7 +208,7 @@ resetcolorstack(char * p, int outtops)
 void
 bopcolor(int outtops)
 {
-   integer pageloc = ftell(dvifile);
+   integer pageloc = dvitell();
    int h = pageloc % COLORHASH;
    struct colorpage *p = colorhash[h];
 
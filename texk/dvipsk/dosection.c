@@ -75,11 +75,11 @@ dosection(sectiontype *s, int c)
       c--;
       prevptr = s->bos;
       if (! reverse)
-         fseek(dvifile, (long)prevptr, 0);
+         dviseek(prevptr);
       np = s->numpages;
       while (np-- != 0) {
          if (reverse)
-            fseek(dvifile, (long)prevptr, 0);
+            dviseek(prevptr);
          pagenum = signedquad();
 	 if ((evenpages && (pagenum & 1)) || (oddpages && (pagenum & 1)==0) ||
 	  (pagelist && !InPageList(pagenum))) {
@@ -127,9 +127,9 @@ dosection(sectiontype *s, int c)
          for (k=0; k<pagecopies; k++) {
             if (k == 0) {
                if (pagecopies > 1)
-                  thispage = ftell(dvifile);
+                  thispage = dvitell();
             } else {
-               fseek(dvifile, (long)thispage, 0);
+               dviseek(thispage);
                if (prettycolumn + 1 > STDOUTSIZE) {
                   fprintf(stderr, "\n");
                   prettycolumn = 0;
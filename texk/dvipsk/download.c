@@ -4,6 +4,13 @@
  *
  */
 #include "dvips.h" /* The copyright notice in that file is included too! */
+#ifdef KPATHSEA
+#include <kpathsea/c-ctype.h>
+#include <kpathsea/c-pathch.h>
+#include <kpathsea/lib.h>
+#include <kpathsea/readable.h>
+#include <kpathsea/variable.h>
+#endif
 #ifndef DOWNLOAD_USING_PDFTEX
 #define DOWNLOAD_USING_PDFTEX
 #endif
@@ -431,45 +438,52 @@ static void addGlyph(const char *glyphName) {
 #endif
 
 /*
- *   Download a PostScript font, using partial font downloading if
- *   necessary.
+ *   Find the first use of the PostScript font of p in the section;
+ *   the font is downloaded only there, and not at all if it has been
+ *   sent as a header already.  Returns 0 if there is nothing to do.
  */
-static void
-downpsfont(charusetype *p, charusetype *all)
+static charusetype *
+firstpsfontuse(charusetype *p, charusetype *all)
 {
-    static unsigned char grid[256];
-    int GridCount;
-    register int b;
-    register halfword bit;
-    register chardesctype *c;
     struct resfont *rf;
-    int cc;
     int j;
 
-    curfnt = p->fd;
-    rf = curfnt->resfont;
+    rf = p->fd->resfont;
     if (rf == 0 || rf->Fontfile == NULL)
-       return;
+       return 0;
     for (; all->fd; all++)
        if (all->fd->resfont &&
            strcmp(rf->PSname, all->fd->resfont->PSname) == 0)
           break;
     if (all != p)
-       return;
+       return 0;
     if (rf->sent == 2) /* sent as header, from a PS file */
-       return;
+       return 0;
     for (j=0; downloadedpsnames[j] && j < unused_top_of_psnames; j++) {
        if (strcmp (downloadedpsnames[j], rf->PSname) == 0)
-          return;
+          return 0;
     }
     if (all->fd == 0)
        error("! internal error in downpsfont");
-    if (!partialdownload) {
-        infont = all->fd->resfont->PSname;
-        copyfile(all->fd->resfont->Fontfile);
-        infont = 0;
-        return;
-    }
+    return all;
+}
+
+/*
+ *   Collect the characters used by all sizes of the PostScript font
+ *   of all->fd in grid (and the glyph names in extraGlyphs); returns
+ *   the number of characters in grid.
+ */
+static int
+psfontgrid(charusetype *all, unsigned char *grid)
+{
+    int GridCount;
+    register int b;
+    register halfword bit;
+    register chardesctype *c;
+    struct resfont *rf;
+    int cc;
+
+    rf = all->fd->resfont;
     for (cc=0; cc<256; cc++)
        grid[cc] = 0;
 #ifdef DOWNLOAD_USING_PDFTEX
@@ -518,6 +532,422 @@ downpsfont(charusetype *p, charusetype *all)
             GridCount++;
         }
     }
+    return GridCount;
+}
+
+#ifdef DOWNLOAD_USING_PDFTEX
+/*
+ *   Write the subset to f instead of the output file.
+ */
+static boolean
+subsettofile(struct resfont *rf, unsigned char *grid, FILE *f)
+{
+   FILE *savefile = bitfile;
+   boolean r;
+
+   bitfile = f;
+   r = t1_subset_2(rf->Fontfile, grid, extraGlyphs);
+   bitfile = savefile;
+   return r && fflush(f) == 0 && !ferror(f);
+}
+
+static void
+copysubset(FILE *f)
+{
+   char buf[BUFSIZ];
+   size_t n;
+
+   rewind(f);
+   while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+      fwrite(buf, 1, n, bitfile);
+}
+#endif
+
+#if defined(DOWNLOAD_USING_PDFTEX) && defined(KPATHSEA)
+/*
+ *   If the kpathsea variable DVIPSFONTCACHE names a directory, font
+ *   subsets are kept there across runs.  A subset is identified by a
+ *   hash of the font file contents, the characters and glyph names
+ *   used, and the dvips version, so repeated builds of the same
+ *   document skip reading, decrypting and subsetting the font files.
+ */
+#define FONTCACHE
+#include <stdint.h>
+#ifndef WIN32
+#include <sys/stat.h>
+#endif
+
+static char *fontcachedir;
+static struct fonthash {
+   struct fonthash *next;
+   char *Fontfile;
+   char *realname;
+   uint64_t hash;
+} *fonthashes;
+
+#define FNVINIT  ((uint64_t)0xcbf29ce484222325ULL)
+
+static uint64_t
+fnvhash(uint64_t h, const unsigned char *s, size_t n)
+{
+   while (n-- > 0) {
+      h ^= *s++;
+      h *= (uint64_t)0x100000001b3ULL;
+   }
+   return h;
+}
+
+/*
+ *   Hash the contents of the font file; each file is read once per run.
+ *   This also sets realnameoffile for the progress report.
+ */
+static struct fonthash *
+hashfontfile(struct resfont *rf)
+{
+   struct fonthash *fh;
+   unsigned char buf[BUFSIZ];
+   size_t n;
+   FILE *f;
+
+   for (fh = fonthashes; fh; fh = fh->next)
+      if (strcmp(fh->Fontfile, rf->Fontfile) == 0)
+         break;
+   if (fh == 0) {
+      if ((f = search(type1path, rf->Fontfile, FOPEN_RBIN_MODE)) == NULL)
+         return 0;
+      fh = (struct fonthash *)mymalloc(sizeof(struct fonthash));
+      fh->Fontfile = rf->Fontfile;
+      fh->realname = xstrdup(realnameoffile);
+      fh->hash = FNVINIT;
+      while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+         fh->hash = fnvhash(fh->hash, buf, n);
+      close_file(f);
+      fh->next = fonthashes;
+      fonthashes = fh;
+   } else {
+      if (realnameoffile)
+         free(realnameoffile);
+      realnameoffile = xstrdup(fh->realname);
+   }
+   return fh;
+}
+
+/*
+ *   The name of the cache file for this subset, or 0 if there is no
+ *   cache.
+ */
+static char *
+subsetcachename(struct resfont *rf, unsigned char *grid)
+{
+   struct fonthash *fh;
+   uint64_t h;
+   char hex[24], *name, *q;
+
+   if (fontcachedir == 0) {
+      fontcachedir = kpse_var_value("DVIPSFONTCACHE");
+      if (fontcachedir == 0 || !dir_p(fontcachedir))
+         fontcachedir = "";
+   }
+   if (*fontcachedir == 0 || (fh = hashfontfile(rf)) == 0)
+      return 0;
+   h = fnvhash(FNVINIT, (const unsigned char *)BANNER, strlen(BANNER));
+   h = fnvhash(h, (const unsigned char *)&fh->hash, sizeof(fh->hash));
+   h = fnvhash(h, grid, 256);
+   if (extraGlyphs)
+      h = fnvhash(h, (const unsigned char *)extraGlyphs, strlen(extraGlyphs));
+   snprintf(hex, sizeof hex, "-%08lx%08lx.pfa",
+           (unsigned long)(h >> 32), (unsigned long)(h & 0xffffffffUL));
+   name = concat3(fontcachedir, DIR_SEP_STRING, rf->PSname);
+   for (q = name + strlen(fontcachedir) + 1; *q; q++)
+      if (!ISALNUM(*q) && *q != '-')
+         *q = '_';
+   q = concat(name, hex);
+   free(name);
+   return q;
+}
+
+/*
+ *   Store the subset in f under name; a uniquely named temporary file
+ *   is renamed so concurrent runs never see a partial entry.
+ */
+static void
+storesubset(const char *name, FILE *f)
+{
+   char buf[BUFSIZ];
+   char *tmpname;
+   size_t n;
+   FILE *out;
+   int ok;
+#ifdef HAVE_MKSTEMP
+   int fd;
+
+   tmpname = concat(name, ".XXXXXX");
+   out = NULL;
+   if ((fd = mkstemp(tmpname)) >= 0) {
+#ifndef WIN32
+      /* mkstemp creates the file private; a cache may be shared */
+      mode_t mask = umask(0);
+
+      umask(mask);
+      fchmod(fd, 0666 & ~mask);
+#endif
+      if ((out = fdopen(fd, FOPEN_WBIN_MODE)) == NULL) {
+         close(fd);
+         remove(tmpname);
+      }
+   }
+#else
+   char pid[24];
+
+   snprintf(pid, sizeof pid, ".%ld", (long)getpid());
+   tmpname = concat(name, pid);
+   out = fopen(tmpname, FOPEN_WBIN_MODE);
+#endif
+   if (out != NULL) {
+      rewind(f);
+      while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+         fwrite(buf, 1, n, out);
+      ok = !ferror(f) && !ferror(out);
+      ok = (fclose(out) == 0) && ok;
+      if (!ok || rename(tmpname, name) != 0)
+         remove(tmpname);
+   }
+   free(tmpname);
+}
+#endif
+
+#if defined(DOWNLOAD_USING_PDFTEX) && defined(KPATHSEA) && !defined(WIN32)
+/*
+ *   With -jobs, the fonts of all sections are subset right after the
+ *   prescan by child processes, each writing one font subset to a
+ *   temporary file; downpsfont then just copies the result.  writet1
+ *   keeps its state in globals, so separate processes are the simple
+ *   way to run several of them at once.  Subsets that are the same in
+ *   several sections (or collated copies) are made only once.
+ */
+#define SUBSETJOBS
+#include <sys/wait.h>
+
+#define MAXSUBSETJOBS 256 /* each keeps a temporary file open */
+
+static struct subsetjob {
+   struct subsetjob *next;
+   char *PSname;
+   unsigned char grid[256];
+   char *extra;
+   FILE *f;
+   pid_t pid;
+   int done; /* 1 if f holds the subset, -1 if the job failed */
+} *subsetjobs;
+static int numsubsetjobs;
+
+static struct subsetjob *
+findsubsetjob(const char *PSname, unsigned char *grid)
+{
+   struct subsetjob *job;
+
+   for (job = subsetjobs; job; job = job->next)
+      if (strcmp(job->PSname, PSname) == 0 &&
+          memcmp(job->grid, grid, 256) == 0 &&
+          (job->extra == 0 ? extraGlyphs == 0 :
+           extraGlyphs != 0 && strcmp(job->extra, extraGlyphs) == 0))
+         return job;
+   return 0;
+}
+
+static void
+waitsubsetjob(void)
+{
+   struct subsetjob *job;
+   pid_t pid;
+   int status;
+
+   pid = wait(&status);
+   if (pid <= 0)
+      return;
+   for (job = subsetjobs; job; job = job->next)
+      if (job->pid == pid) {
+         job->pid = 0;
+         job->done = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 1 : -1;
+         break;
+      }
+}
+
+static void
+startsubsetjob(struct resfont *rf, unsigned char *grid)
+{
+   struct subsetjob *job;
+   int running;
+   pid_t pid;
+   FILE *f;
+
+   if (numsubsetjobs >= MAXSUBSETJOBS || (f = tmpfile()) == NULL)
+      return;
+   for (;;) {
+      running = 0;
+      for (job = subsetjobs; job; job = job->next)
+         if (job->pid > 0)
+            running++;
+      if (running < fontjobs)
+         break;
+      waitsubsetjob();
+   }
+   fflush(NULL); /* don't let the child flush our buffers again */
+   pid = fork();
+   if (pid < 0) {
+      fclose(f);
+      return;
+   }
+   if (pid == 0)
+      _exit(subsettofile(rf, grid, f) ? 0 : 1);
+   job = (struct subsetjob *)mymalloc(sizeof(struct subsetjob));
+   job->PSname = rf->PSname;
+   memcpy(job->grid, grid, 256);
+   job->extra = extraGlyphs ? xstrdup(extraGlyphs) : 0;
+   job->f = f;
+   job->pid = pid;
+   job->done = 0;
+   job->next = subsetjobs;
+   subsetjobs = job;
+   numsubsetjobs++;
+}
+
+void
+subsetpsfonts(sectiontype *fs)
+{
+   static unsigned char grid[256];
+   charusetype *cu, *all;
+   struct subsetjob *job;
+#ifdef FONTCACHE
+   char *name;
+#endif
+
+   for (; fs; fs = fs->next)
+      for (cu = (charusetype *) (fs + 1); cu->fd; cu++) {
+         all = firstpsfontuse(cu, (charusetype *) (fs + 1));
+         if (all == 0)
+            continue;
+         if (psfontgrid(all, grid) == 0 && extraGlyphs == 0)
+            continue;
+         if (findsubsetjob(cu->fd->resfont->PSname, grid) != 0)
+            continue;
+#ifdef FONTCACHE
+         if ((name = subsetcachename(cu->fd->resfont, grid)) != 0) {
+            int cached = kpse_readable_file(name) != 0;
+
+            free(name);
+            if (cached)
+               continue;
+         }
+#endif
+         startsubsetjob(cu->fd->resfont, grid);
+      }
+   for (;;) {
+      for (job = subsetjobs; job; job = job->next)
+         if (job->pid > 0)
+            break;
+      if (job == 0)
+         break;
+      waitsubsetjob();
+   }
+}
+
+/*
+ *   The subset made by a job, if there is one.
+ */
+static FILE *
+subsetjobfile(struct resfont *rf, unsigned char *grid)
+{
+   struct subsetjob *job;
+
+   job = findsubsetjob(rf->PSname, grid);
+   if (job == 0 || job->done != 1)
+      return 0;
+   return job->f;
+}
+#else
+void
+subsetpsfonts(sectiontype *fs)
+{
+}
+#endif
+
+#ifdef DOWNLOAD_USING_PDFTEX
+/*
+ *   Send the subset, from the cache or a finished job if possible.
+ */
+static boolean
+sendsubset(struct resfont *rf, unsigned char *grid)
+{
+   FILE *f = 0;
+   boolean ok = 1;
+   int tmp = 0;
+#ifdef FONTCACHE
+   char *name;
+#endif
+
+   /* set realnameoffile for the progress report */
+   if ((f = search(type1path, rf->Fontfile, FOPEN_RBIN_MODE)) != NULL) {
+      close_file(f);
+      f = 0;
+   }
+#ifdef FONTCACHE
+   name = subsetcachename(rf, grid);
+
+   if (name && (f = fopen(name, FOPEN_RBIN_MODE)) != NULL) {
+      copysubset(f);
+      fclose(f);
+      free(name);
+      return 1;
+   }
+#endif
+#ifdef SUBSETJOBS
+   f = subsetjobfile(rf, grid);
+#endif
+#ifdef FONTCACHE
+   if (name) {
+      if (f == 0 && (f = tmpfile()) != NULL) {
+         tmp = 1;
+         ok = subsettofile(rf, grid, f);
+      }
+      if (f && ok)
+         storesubset(name, f);
+      free(name);
+   }
+#endif
+   if (f == 0)
+      return t1_subset_2(rf->Fontfile, grid, extraGlyphs);
+   if (ok)
+      copysubset(f);
+   if (tmp)
+      fclose(f);
+   return ok;
+}
+#endif
+
+/*
+ *   Download a PostScript font, using partial font downloading if
+ *   necessary.
+ */
+static void
+downpsfont(charusetype *p, charusetype *all)
+{
+    static unsigned char grid[256];
+    int GridCount;
+    struct resfont *rf;
+
+    curfnt = p->fd;
+    rf = curfnt->resfont;
+    all = firstpsfontuse(p, all);
+    if (all == 0)
+       return;
+    if (!partialdownload) {
+        infont = all->fd->resfont->PSname;
+        copyfile(all->fd->resfont->Fontfile);
+        infont = 0;
+        return;
+    }
+    GridCount = psfontgrid(all, grid);
     if(GridCount!=0
 #ifdef DOWNLOAD_USING_PDFTEX
        || extraGlyphs
@@ -527,7 +957,7 @@ downpsfont(charusetype *p, charusetype *all)
         if (! disablecomments)
            fprintf(bitfile, "%%%%BeginFont: %s\n",  rf->PSname);
 #ifdef DOWNLOAD_USING_PDFTEX
-        if (!t1_subset_2(rf->Fontfile, grid, extraGlyphs))
+        if (!sendsubset(rf, grid))
 #else
         if(FontPart(bitfile, rf->Fontfile, rf->Vectfile) < 0)
 #endif
@@ -1,33 +1,102 @@
 /*
  *   Input bytes from the dvi file or the current virtual character.
- *   These routines could probably be sped up significantly; but they are
- *   very machine dependent, so I will leave such tuning to the installer.
  *   They simply get and return bytes in batches of one, two, three, and four,
  *   updating the current position as necessary.
+ *
+ *   The whole dvi file is brought into memory first by readdvifile, so
+ *   that decoding a page is a matter of walking a pointer, and moving
+ *   to another page (for page selection or the second pass) is just an
+ *   assignment.  Where we can we map the file; otherwise (a pipe, as
+ *   with -f, or a system without mmap) we read it in.
  */
 #include "dvips.h" /* The copyright notice in that file is included too! */
+#if defined(KPATHSEA) && !defined(WIN32)
+#define MMAPDVI
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
 /*
  *   The external declarations:
  */
 #include "protos.h"
 
+static quarterword *dvibase, *dviptr, *dvilim;
+
 static void
 abortpage(void)
 {
    error("! unexpected eof on DVI file");
 }
 
+void
+readdvifile(void)
+{
+   size_t size, room;
+   size_t n;
+   quarterword *p;
+#ifdef MMAPDVI
+   struct stat st;
+
+   if (fstat(fileno(dvifile), &st) == 0 && S_ISREG(st.st_mode)
+       && st.st_size > 0 && (off_t)(size_t)st.st_size == st.st_size) {
+      p = (quarterword *)mmap(NULL, (size_t)st.st_size, PROT_READ,
+                              MAP_PRIVATE, fileno(dvifile), (off_t)0);
+      if (p != (quarterword *)MAP_FAILED) {
+         dvibase = dviptr = p;
+         dvilim = p + st.st_size;
+         return;
+      }
+   }
+#endif
+   size = 0;
+   room = 65536;
+   p = (quarterword *)malloc(room);
+   while (p != NULL && (n = fread(p + size, 1, room - size, dvifile)) > 0) {
+      size += n;
+      if (size == room) {
+         room *= 2;
+         p = (quarterword *)realloc(p, room);
+      }
+   }
+   if (p == NULL)
+      error("! no memory for DVI file");
+   if (ferror(dvifile)) {
+      error_with_perror("DVI file can't be read:", iname);
+      exit(1);
+   }
+   dvibase = dviptr = p;
+   dvilim = p + size;
+}
+
+/*
+ *   ftell and fseek on the dvi file.
+ */
+integer
+dvitell(void)
+{
+   return (integer)(dviptr - dvibase);
+}
+
+void
+dviseek(integer pos)
+{
+   if (pos < 0 || pos > dvilim - dvibase)
+      dviptr = dvilim;
+   else
+      dviptr = dvibase + pos;
+}
+
 shalfword  /* the value returned is, however, between 0 and 255 */
 dvibyte(void)
 {
-  register shalfword i;
   if (curpos) {
      if (curpos>=curlim) return((shalfword)140);
      return (*curpos++);
   }
-  if ((i=getc(dvifile))==EOF)
+  if (dviptr>=dvilim)
     abortpage();
-  return(i);
+  return(*dviptr++);
 }
 
 halfword
@@ -52,8 +121,11 @@ signedbyte(void)
      if (curpos>=curlim)
        error("! unexpected end of virtual packet");
      i = *curpos++;
-  } else if ((i=getc(dvifile))==EOF)
-    abortpage();
+  } else {
+     if (dviptr>=dvilim)
+       abortpage();
+     i = *dviptr++;
+  }
   if (i<128) return(i);
   else return(i-256);
 }
@@ -85,5 +157,11 @@ signedquad(void)
 void
 skipover(int i)
 {
-  while (i-->0) dvibyte();
+  if (curpos) {
+     while (i-->0) dvibyte();
+  } else if (i > 0) {
+     if (i > dvilim - dviptr)
+       abortpage();
+     dviptr += i;
+  }
 }
@@ -93,6 +93,7 @@ fontdesctype *fonthead;      /* list of all fonts mentioned so far */
 fontdesctype *curfnt;        /* the currently selected font */
 sectiontype *sections;       /* sections to process document in */
 Boolean partialdownload = 1; /* turn on partial downloading */
+int fontjobs = 1;            /* processes for partial font downloading */
 Boolean manualfeed;          /* manual feed? */
 Boolean compressed;          /* compressed? */
 Boolean downloadpspk;        /* use PK for downloaded PS fonts? */
@@ -299,6 +300,7 @@ static const char *helparr[] = {
 "-h f Add header file",
 "-i*  Separate file per section",
 "-j*  Download fonts partially",
+"-jobs # Subset fonts in # parallel processes",
 "-k*  Print crop marks                -K*  Pull comments from inclusions",
 "-l # Last page                       -L*  Last special papersize wins",
 "-m*  Manual feed                     -M*  Don't make fonts",
@@ -849,7 +851,11 @@ case 'i':
                }
                break;
 case 'j':
-               partialdownload = (*p != '0');
+               if (STREQ (p, "obs") && argv[i+1]) {
+                  if (sscanf(argv[++i], "%d", &fontjobs)==0 || fontjobs < 1)
+                     error("! Bad number of jobs option (-jobs).");
+               } else
+                  partialdownload = (*p != '0');
                break;
 case 'k':
                cropmarks = (*p != '0');
@@ -1397,8 +1403,7 @@ default:
       error_with_perror("DVI file can't be opened:", iname);
       exit(1);
    }
-   if (fseek(dvifile, 0L, 0) < 0)
-      error("! DVI file must not be a pipe.");
+   readdvifile();
 
    initcolor();
 #ifdef FONTLIB
@@ -1427,6 +1432,8 @@ default:
    if (dopprescan)
       pprescanpages();
    prescanpages();
+   if (fontjobs > 1 && partialdownload)
+      subsetpsfonts(sections);
 #if defined MSDOS || defined OS2 || defined(ATARIST)
    if (mfjobfile != (FILE*)NULL) {
      char answer[5];
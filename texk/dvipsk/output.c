@@ -6,6 +6,12 @@
  *   mail messages and many mailers mutilate longer lines.
  */
 #define LINELENGTH (72)
+/*
+ *   OUTBUFSIZE is the stdio buffer we give bitfile.  The token writers
+ *   below produce a few bytes at a time, so with the default buffer a
+ *   pipe to a spooler sees a great many small writes.
+ */
+#define OUTBUFSIZE (65536)
 #include "dvips.h" /* The copyright notice in that file is included too! */
 #include <ctype.h>
 #include <stdlib.h>
@@ -58,6 +64,7 @@ integer rdir = 0, fdir = 0;
  *   We need a few statics to take care of things.
  */
 static void chrcmd(char c);
+static void tokenout(const char *s, int l);
 static void tell_needed_fonts(void);
 static void print_composefont(void);
 static void setdir(int d);
@@ -856,14 +863,20 @@ jscout(int c, char *fs)   /* string character out */
 void
 cmdout(const char *s)
 {
-   int l;
+   tokenout(s, strlen(s));
+}
 
+/*
+ *   cmdout for a token whose length we already know.
+ */
+static void
+tokenout(const char *s, int l)
+{
    /* hack added by dorab */
    if (instring && !jflag) {
         stringend();
         chrcmd('p');
    }
-   l = strlen(s);
    if ((! lastspecial && linepos >= LINELENGTH - 20) ||
            linepos + l >= LINELENGTH) {
       putc('\n', bitfile);
@@ -872,7 +885,7 @@ cmdout(const char *s)
       putc(' ', bitfile);
       linepos++;
    }
-   fputs(s, bitfile);
+   fwrite(s, 1, l, bitfile);
    linepos += l;
    lastspecial = 0;
 }
@@ -923,17 +936,25 @@ doubleout(double n)
    cmdout(buf);
 }
 
+/*
+ *   numout is called for nearly every position change, so we convert
+ *   the number ourselves instead of going through printf.
+ */
 void
 numout(integer n)
 {
-   char buf[50];
-
-#ifdef SHORTINT
-   snprintf(buf, sizeof(buf), "%ld", n);
-#else
-   snprintf(buf, sizeof(buf), "%d", n);
-#endif
-   cmdout(buf);
+   char buf[24];
+   register char *p = buf + sizeof(buf);
+   register unsigned long u;
+
+   u = (n < 0) ? -(unsigned long)n : (unsigned long)n;
+   do {
+      *--p = (char)('0' + u % 10);
+      u /= 10;
+   } while (u);
+   if (n < 0)
+      *--p = '-';
+   tokenout(p, (int)(buf + sizeof(buf) - p));
 }
 
 void
@@ -942,6 +963,8 @@ mhexout(register unsigned char *p,
 {
    register const char *hexchar = hxdata;
    register int n, k;
+   register char *q;
+   char line[LINELENGTH];
 
    while (len > 0) {
       if (linepos > LINELENGTH - 2) {
@@ -953,11 +976,13 @@ mhexout(register unsigned char *p,
          k = len;
       len -= k;
       linepos += (k << 1);
+      q = line;
       while (k--) {
          n = *p++;
-         putc(hexchar[n >> 4], bitfile);
-         putc(hexchar[n & 15], bitfile);
+         *q++ = hexchar[n >> 4];
+         *q++ = hexchar[n & 15];
       }
+      fwrite(line, 1, q - line, bitfile);
    }
 }
 
@@ -1407,6 +1432,8 @@ open_output(void) {
       bitfile to binary mode.  */
    if (O_BINARY && !isatty(fileno(bitfile)))
       SET_BINARY(fileno(bitfile));
+   if (!isatty(fileno(bitfile)))
+      setvbuf(bitfile, NULL, _IOFBF, OUTBUFSIZE);
 }
 void
 initprinter(sectiontype *sect)
@@ -1612,7 +1639,7 @@ cleanprinter(void)
       fprintf(bitfile, "%%%%EOF\n");
    if (sendcontrolD)
       putc(4, bitfile);
-   if (ferror(bitfile))
+   if (fflush(bitfile) != 0 || ferror(bitfile))
       error("Problems with file writing; probably disk full.");
 #if !defined(MSDOS) || defined(__DJGPP__)
 #ifndef VMS
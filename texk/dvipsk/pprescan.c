@@ -279,6 +279,6 @@ pprescanpages(void)
       skipover(40);
       pageseq++;
    }
-   fseek(dvifile, 0L, 0);
+   dviseek(0);
    pprescan = 0;
 }
@@ -79,7 +79,7 @@ prescanpages(void)
          error("! End of document before first specified page");
       if (cmd!=139)
          error("! Bad DVI file: expected bop");
-      thispageloc = ftell(dvifile); /* the location FOLLOWING the bop */
+      thispageloc = dvitell(); /* the location FOLLOWING the bop */
 #ifdef DEBUG
       if (dd(D_PAGE))
 #ifdef SHORTINT
@@ -127,7 +127,7 @@ prescanpages(void)
  *   be a page that was aborted because the previous section overflowed memory).
  */
       pagecount = 0;
-      fseek(dvifile, (long)thispageloc, 0);
+      dviseek(thispageloc);
       pagenum = signedquad();
       skipover(40);
       thissecloc = thispageloc;
@@ -173,7 +173,7 @@ prescanpages(void)
          if (cmd==248) break;
          if (cmd!=139)
             error("! Bad DVI file: expected bop");
-         thispageloc = ftell(dvifile);
+         thispageloc = dvitell();
 #ifdef DEBUG
          if (dd(D_PAGE))
 #ifdef SHORTINT
@@ -52,6 +52,7 @@ extern void download(charusetype *p, int psfont);
 extern void makepsname(char *s, int n);
 extern void lfontout(int n);
 extern void dopsfont(sectiontype *fs);
+extern void subsetpsfonts(sectiontype *fs);
 
 /* prototypes for functions from dpicheck.c */
 extern unsigned short dpicheck(unsigned short dpi);
@@ -71,6 +72,9 @@ extern void blackenLast(void);
 #endif /* TPIC */
 
 /* prototypes for functions from dviinput.c */
+extern void readdvifile(void);
+extern int dvitell(void);
+extern void dviseek(int pos);
 extern short dvibyte(void);
 extern unsigned short twobytes(void);
 extern int threebytes(void);
@@ -267,6 +271,7 @@ extern fontdesctype *fonthead;
 extern fontdesctype *curfnt;
 extern sectiontype *sections;
 extern Boolean partialdownload;
+extern int fontjobs;
 extern Boolean manualfeed;
 extern Boolean compressed;
 extern Boolean downloadpspk;
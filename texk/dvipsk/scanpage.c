@@ -116,7 +116,7 @@ scanpage(void)
    register frametype *frp = frames;
 
   if (firstboploc == 0)
-     firstboploc = ftell(dvifile);
+     firstboploc = dvitell();
    pagecost = 0;
 #ifdef DEBUG
    if (dd(D_PAGE))
@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <vector>
@@ -91,20 +92,45 @@ Color ColorSpecialHandler::readColor (istream &is) {
 }
 
 
-bool ColorSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
+/** Applies a color special to a given color stack. */
+static void execute_color_special (istream &is, stack<Color> &colorStack) {
 	string cmd;
 	is >> cmd;
 	if (cmd == "push")               // color push <model> <params>
-		_colorStack.push(readColor(is));
+		colorStack.push(ColorSpecialHandler::readColor(is));
 	else if (cmd == "pop") {
-		if (!_colorStack.empty())     // color pop
-			_colorStack.pop();
+		if (!colorStack.empty())      // color pop
+			colorStack.pop();
 	}
 	else {                           // color <model> <params>
-		while (!_colorStack.empty())
-			_colorStack.pop();
-		_colorStack.push(readColor(cmd, is));
+		while (!colorStack.empty())
+			colorStack.pop();
+		colorStack.push(ColorSpecialHandler::readColor(cmd, is));
+	}
+}
+
+
+/** Collects the color stacks left at the end of the pages while preprocessing the
+ *  DVI file. They are needed to restore the color stack at the beginning of a page
+ *  if the preceding page hasn't been converted right before, i.e. if only selected
+ *  pages are converted or if the pages are distributed among parallel jobs. */
+void ColorSpecialHandler::preprocess (const string&, istream &is, SpecialActions &actions) {
+	try {
+		execute_color_special(is, _prescanColorStack);
+	}
+	catch (const SpecialException&) {
+		return;  // reported when the page is converted
 	}
+	unsigned pageno = actions.getCurrentPageNumber();
+	if (!_pageColorStacks.empty() && _pageColorStacks.back().first == pageno)
+		_pageColorStacks.back().second = _prescanColorStack;
+	else
+		_pageColorStacks.emplace_back(pageno, _prescanColorStack);
+}
+
+
+bool ColorSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
+	execute_color_special(is, _colorStack);
 	if (_colorStack.empty())
 		actions.setColor(Color::BLACK);
 	else
@@ -113,6 +139,20 @@ bool ColorSpecialHandler::process (const string&, istream &is, SpecialActions &a
 }
 
 
+void ColorSpecialHandler::dviBeginPage (unsigned pageno, SpecialActions &actions) {
+	// find the color stack left by the last preceding page that changed it
+	auto it = lower_bound(_pageColorStacks.begin(), _pageColorStacks.end(), pageno,
+		[](const PageColorStack &pcs, unsigned pageno) {return pcs.first < pageno;});
+	stack<Color> colorStack;
+	if (it != _pageColorStacks.begin())
+		colorStack = (--it)->second;
+	if (colorStack != _colorStack) {
+		_colorStack = std::move(colorStack);
+		actions.setColor(_colorStack.empty() ? Color::BLACK : _colorStack.top());
+	}
+}
+
+
 vector<const char*> ColorSpecialHandler::prefixes() const {
 	vector<const char*> pfx {"color"};
 	return pfx;
@@ -23,6 +23,7 @@
 
 #include <stack>
 #include <string>
+#include <utility>
 #include <vector>
 #include "Color.hpp"
 #include "SpecialHandler.hpp"
@@ -30,6 +31,7 @@
 
 class ColorSpecialHandler : public SpecialHandler {
 	public:
+		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		static Color readColor (std::istream &is);
 		static Color readColor (const std::string &model, std::istream &is);
@@ -37,8 +39,14 @@ class ColorSpecialHandler : public SpecialHandler {
 		const char* info () const override {return "complete support of color specials";}
 		std::vector<const char*> prefixes() const override;
 
+	protected:
+		void dviBeginPage (unsigned pageno, SpecialActions &actions) override;
+
 	private:
+		using PageColorStack = std::pair<unsigned,std::stack<Color>>;  // page number and color stack
 		std::stack<Color> _colorStack;
+		std::stack<Color> _prescanColorStack;    ///< color stack while preprocessing the DVI file
+		std::vector<PageColorStack> _pageColorStacks;  ///< color stacks left by the pages
 };
 
 #endif
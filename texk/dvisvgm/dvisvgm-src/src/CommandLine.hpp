@@ -43,6 +43,7 @@ class CommandLine : public CL::CommandLine {
 		TypedOption<int, Option::ArgMode::REQUIRED> gradSegmentsOpt {"grad-segments", '\0', "number", 20, "number of color gradient segments per row"};
 		TypedOption<double, Option::ArgMode::REQUIRED> gradSimplifyOpt {"grad-simplify", '\0', "delta", 0.05, "reduce level of detail for small segments"};
 		TypedOption<int, Option::ArgMode::OPTIONAL> helpOpt {"help", 'h', "mode", 0, "print this summary of options and exit"};
+		TypedOption<unsigned, Option::ArgMode::REQUIRED> jobsOpt {"jobs", '\0', "number", 1, "number of pages converted in parallel"};
 		Option keepOpt {"keep", '\0', "keep temporary files"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> libgsOpt {"libgs", '\0', "filename", "set name of Ghostscript shared library"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> linkmarkOpt {"linkmark", 'L', "style", "box", "select how to mark hyperlinked areas"};
@@ -61,6 +62,7 @@ class CommandLine : public CL::CommandLine {
 		TypedOption<int, Option::ArgMode::REQUIRED> precisionOpt {"precision", 'd', "number", 0, "set number of decimal points (0-6)"};
 		TypedOption<double, Option::ArgMode::OPTIONAL> progressOpt {"progress", '\0', "delay", 0.5, "enable progress indicator"};
 		Option relativeOpt {"relative", 'R', "create relative path commands"};
+		Option replayPsOpt {"replay-ps", '\0', "reuse output of recurring literal PS specials"};
 		TypedOption<double, Option::ArgMode::REQUIRED> rotateOpt {"rotate", 'r', "angle", "rotate page content clockwise"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> scaleOpt {"scale", 'c', "sx[,sy]", "scale page content"};
 		Option stdinOpt {"stdin", '\0', "read input file from stdin"};
@@ -136,6 +138,9 @@ class CommandLine : public CL::CommandLine {
 			{&zoomOpt, 2},
 			{&cacheOpt, 3},
 			{&exactBboxOpt, 3},
+#if !defined(_WIN32)
+			{&jobsOpt, 3},
+#endif
 			{&keepOpt, 3},
 #if !defined(HAVE_LIBGS) && !defined(DISABLE_GS)
 			{&libgsOpt, 3},
@@ -144,6 +149,9 @@ class CommandLine : public CL::CommandLine {
 			{&noMktexmfOpt, 3},
 			{&noSpecialsOpt, 3},
 			{&pageHashesOpt, 3},
+#if !defined(DISABLE_GS)
+			{&replayPsOpt, 3},
+#endif
 			{&traceAllOpt, 3},
 			{&colorOpt, 4},
 			{&helpOpt, 4},
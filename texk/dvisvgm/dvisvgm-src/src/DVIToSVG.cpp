@@ -19,21 +19,30 @@
 *************************************************************************/
 
 #include <config.h>
+#ifndef _WIN32
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+#include <cerrno>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
+#include <iostream>
 #include <set>
 #include <sstream>
 #include "Calculator.hpp"
 #include "DVIToSVG.hpp"
 #include "DVIToSVGActions.hpp"
+#include "FileFinder.hpp"
 #include "FileSystem.hpp"
 #include "Font.hpp"
+#include "FontEngine.hpp"
 #include "FontManager.hpp"
 #include "GlyphTracerMessages.hpp"
 #include "InputBuffer.hpp"
 #include "InputReader.hpp"
+#include "Message.hpp"
 #include "PageRanges.hpp"
 #include "PageSize.hpp"
 #include "PreScanDVIReader.hpp"
@@ -71,6 +80,7 @@ using namespace std;
  *   0 : only trace actually required glyphs */
 char DVIToSVG::TRACE_MODE = 0;
 bool DVIToSVG::COMPUTE_PROGRESS = false;
+unsigned DVIToSVG::PARALLEL_JOBS = 1;
 DVIToSVG::HashSettings DVIToSVG::PAGE_HASH_SETTINGS;
 
 
@@ -121,6 +131,8 @@ void DVIToSVG::convert (unsigned first, unsigned last, HashFunction *hashFunc) {
 		else {
 			executePage(i);
 			SVGOptimizer(_svg).execute();
+			// linked font files are placed next to the SVG file (not possible when writing to stdout)
+			_svg.setFontFileDir(path.empty() ? "" : path.absolute(false));
 			embedFonts(_svg.rootNode());
 			bool success = _svg.write(_out.getPageStream(currentPageNumber(), numberOfPages(), hashTriple));
 			string fname = path.shorterAbsoluteOrRelative();
@@ -170,14 +182,18 @@ void DVIToSVG::convert (const string &rangestr, pair<int,int> *pageinfo) {
 		actions->setDVIReader(*this);
 		SpecialManager::instance().notifyPreprocessingFinished();
 		executeFontDefs();
+		if (PARALLEL_JOBS > 1)
+			runMetafontInJobs();
 	}
 
 	unique_ptr<HashFunction> hashFunc;
 	if (!PAGE_HASH_SETTINGS.algorithm().empty())  // name of hash algorithm present?
 		hashFunc = create_hash_function(PAGE_HASH_SETTINGS.algorithm());
 
-	for (const auto &range : ranges)
-		convert(range.first, range.second, hashFunc.get());
+	if (PARALLEL_JOBS < 2 || ranges.numberOfPages() < 2 || !convertInJobs(ranges, hashFunc.get())) {
+		for (const auto &range : ranges)
+			convert(range.first, range.second, hashFunc.get());
+	}
 	if (pageinfo) {
 		pageinfo->first = ranges.numberOfPages();
 		pageinfo->second = numberOfPages();
@@ -185,6 +201,169 @@ void DVIToSVG::convert (const string &rangestr, pair<int,int> *pageinfo) {
 }
 
 
+/** Converts the selected pages in PARALLEL_JOBS processes. The child processes are
+ *  forked after the DVI file has been pre-scanned and the fonts have been loaded.
+ *  Glyphs traced by a child process are not passed back to the parent. They only
+ *  reach the font cache (if enabled) that the processes write concurrently.
+ *  The special handlers restore the state carried from one page to the next from
+ *  the data collected during the pre-scan. If that's not possible, e.g. because
+ *  of literal PostScript code, the pages are converted one after another.
+ *  Job n converts every PARALLEL_JOBS-th page starting at the n-th selected page.
+ *  The calling process takes the first share itself.
+ *  @param[in] ranges pages to convert
+ *  @param[in] hashFunc pointer to function to be used to compute page hashes
+ *  @return false if no child process could be started */
+bool DVIToSVG::convertInJobs (const PageRanges &ranges, HashFunction *hashFunc) {
+#ifdef _WIN32
+	return false;
+#else
+	if (_inputFilePath.empty())
+		return false;
+	if (SpecialManager::instance().carriesPageState()) {
+		Message::wstream(true) << "specials may pass state between pages, ignoring option --jobs\n";
+		return false;
+	}
+	vector<unsigned> pages;
+	for (const auto &range : ranges)
+		for (int i=range.first; i <= range.second; i++)
+			pages.push_back(i);
+	unsigned numJobs = min(PARALLEL_JOBS, unsigned(pages.size()));
+	auto convert_share = [&](unsigned job) {
+		for (size_t i=job; i < pages.size(); i+=numJobs) {
+			// number the pages as if they were converted one after another
+			if (auto actions = dynamic_cast<DVIToSVGActions*>(_actions.get()))
+				actions->setPageCount(int(i));
+			convert(pages[i], pages[i], hashFunc);
+		}
+	};
+	// Close the font file currently opened by FreeType. Otherwise, all processes
+	// would read it through the same file offset.
+	FontEngine::instance().releaseFont();
+	cout.flush();
+	cerr.flush();
+	vector<pid_t> pids;
+	for (unsigned job=1; job < numJobs; job++) {
+		pid_t pid = fork();
+		if (pid < 0)
+			break;
+		if (pid == 0) {  // child process
+			int status = 0;
+			Message::LEVEL &= ~Message::WARNINGS;
+			try {
+				// read the DVI file through a separate file offset
+				ifstream ifs(_inputFilePath, ios::binary);
+				if (!ifs)
+					throw MessageException("can't open file '" + _inputFilePath + "' for reading");
+				replaceStream(ifs);
+				convert_share(job);
+				_out.finish();  // _exit doesn't run the destructors, so close the last page here
+				PhysicalFont::writeCache();
+			}
+			catch (exception &e) {
+				Message::estream(true) << e.what() << '\n';
+				status = 1;
+			}
+			cout.flush();
+			cerr.flush();
+			_exit(status);  // leave the cleanup to the parent process
+		}
+		pids.push_back(pid);
+	}
+	if (pids.empty())
+		return false;
+	auto wait_for_jobs = [&]() {
+		bool success = true;
+		for (pid_t pid : pids) {
+			int status;
+			while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				success = false;
+		}
+		return success;
+	};
+	try {
+		convert_share(0);
+		for (unsigned job=pids.size()+1; job < numJobs; job++)  // shares of jobs that couldn't be started
+			convert_share(job);
+	}
+	catch (...) {
+		wait_for_jobs();
+		throw;
+	}
+	if (!wait_for_jobs())
+		throw MessageException("conversion of some pages failed");
+	return true;
+#endif
+}
+
+
+/** Calls Metafont for all Metafont fonts defined in the DVI file whose glyphs
+ *  are not cached yet. Since each Metafont run takes a considerable amount of time
+ *  compared to the rest of the conversion, up to PARALLEL_JOBS fonts are processed
+ *  concurrently by child processes. If caching is enabled, the child processes also
+ *  trace the glyphs and add them to the font cache, otherwise they only leave the
+ *  GF files in the temporary folder. Fonts that fail here are processed again later
+ *  in the regular way, which also reports the errors. Therefore, the child processes
+ *  don't print any warnings. */
+void DVIToSVG::runMetafontInJobs () {
+#ifndef _WIN32
+	vector<const PhysicalFont*> fonts;
+	set<string> fontnames;
+	const Font *font;
+	for (int id=0; (font = FontManager::instance().getFontById(id)) != nullptr; id++) {
+		auto pf = dynamic_cast<const PhysicalFont*>(font->uniqueFont());
+		if (!pf || pf->type() != PhysicalFont::Type::MF || !fontnames.insert(pf->name()).second)
+			continue;
+		if (!PhysicalFont::CACHE_PATH.empty() && FileSystem::exists(PhysicalFont::CACHE_PATH+"/"+pf->name()+".fgd"))
+			continue;
+		if (FileSystem::exists(FileSystem::tmpdir()+pf->name()+".gf") || !FileFinder::instance().lookup(pf->name()+".mf", false))
+			continue;
+		fonts.push_back(pf);
+	}
+	if (fonts.size() < 2)  // nothing to gain from a child process
+		return;
+	cout.flush();
+	cerr.flush();
+	set<pid_t> pids;
+	auto wait_for_job = [&]() {
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid > 0)
+			pids.erase(pid);
+		else if (errno != EINTR)
+			pids.clear();  // no more child processes to wait for
+	};
+	for (const PhysicalFont *pf : fonts) {
+		while (pids.size() >= PARALLEL_JOBS)
+			wait_for_job();
+		pid_t pid = fork();
+		if (pid < 0)
+			break;
+		if (pid == 0) {  // child process
+			int status = 0;
+			Message::LEVEL &= ~Message::WARNINGS;
+			try {
+				string gfname;
+				if (!PhysicalFont::CACHE_PATH.empty())
+					pf->traceAllGlyphs(false);
+				else if (!pf->createGF(gfname))
+					status = 1;
+			}
+			catch (...) {
+				status = 1;
+			}
+			cout.flush();
+			cerr.flush();
+			_exit(status);  // leave the cleanup to the parent process
+		}
+		pids.insert(pid);
+	}
+	while (!pids.empty())
+		wait_for_job();
+#endif
+}
+
+
 /** Writes the hash values of a selected set of pages to an output stream.
  *  @param[in] rangestr string describing the pages to convert
  *  @param[in,out] os stream the output is written to */
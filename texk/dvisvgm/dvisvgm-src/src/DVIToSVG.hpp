@@ -31,6 +31,7 @@
 struct DVIActions;
 struct SVGOutputBase;
 class HashFunction;
+class PageRanges;
 
 class DVIToSVG : public DVIReader {
 	public:
@@ -55,6 +56,7 @@ class DVIToSVG : public DVIReader {
 		void convert (const std::string &range, std::pair<int,int> *pageinfo=nullptr);
 		void setPageSize (const std::string &format)         {_bboxFormatString = format;}
 		void setPageTransformation (const std::string &cmds) {_transCmds = cmds;}
+		void setInputFilePath (const std::string &path)     {_inputFilePath = path;}
 		Matrix getPageTransformation () const override;
 		void translateToX (double x) override {_tx = x-dviState().h-_tx;}
 		void translateToY (double y) override {_ty = y-dviState().v-_ty;}
@@ -70,10 +72,13 @@ class DVIToSVG : public DVIReader {
 	public:
 		static bool COMPUTE_PROGRESS;  ///< if true, an action to handle the progress ratio of a page is triggered
 		static char TRACE_MODE;
+		static unsigned PARALLEL_JOBS; ///< number of processes converting pages concurrently
 		static HashSettings PAGE_HASH_SETTINGS;
 
 	protected:
 		void convert (unsigned firstPage, unsigned lastPage, HashFunction *hashFunc);
+		bool convertInJobs (const PageRanges &ranges, HashFunction *hashFunc);
+		void runMetafontInJobs ();
 		int executeCommand () override;
 		void enterBeginPage (unsigned pageno, const std::vector<int32_t> &c);
 		void leaveEndPage (unsigned pageno);
@@ -103,6 +108,7 @@ class DVIToSVG : public DVIReader {
 		std::unique_ptr<DVIActions> _actions;
 		std::string _bboxFormatString;  ///< bounding box size/format set by the user
 		std::string _transCmds;         ///< page transformation commands set by the user
+		std::string _inputFilePath;     ///< path of the DVI file (used to reopen it in parallel jobs)
 		double _pageHeight, _pageWidth; ///< global page height and width stored in the postamble
 		double _tx, _ty;                ///< translation of cursor position
 		double _prevXPos, _prevYPos;    ///< previous cursor position
@@ -81,6 +81,7 @@ class DVIToSVGActions : public DVIActions, public SpecialActions {
 		CharMap& getUsedChars () const        {return _usedChars;}
 		const FontSet& getUsedFonts () const  {return _usedFonts;}
 		void setDVIReader (BasicDVIReader &r) {_dvireader = &r;}
+		void setPageCount (int count)         {_pageCount = count;}
 
 	private:
 		SVGTree &_svg;
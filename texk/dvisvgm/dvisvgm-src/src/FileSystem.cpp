@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #include "FileSystem.hpp"
 #include "utility.hpp"
 #include "version.hpp"
@@ -38,10 +39,12 @@ using namespace std;
 
 #ifdef _WIN32
 	#include <direct.h>
+	#include <process.h>
 	#include "windows.hpp"
 	const char *FileSystem::DEVNULL = "nul";
 	const char FileSystem::PATHSEP = '\\';
 	#define unlink _unlink
+	#define getpid _getpid
 #else
 	#include <dirent.h>
 	#include <pwd.h>
@@ -113,6 +116,33 @@ bool FileSystem::rename (const string &oldname, const string &newname) {
 }
 
 
+/** Writes a file by passing an output stream to a given function. The data goes
+ *  to a temporary file first which then replaces the target file. Thus, concurrent
+ *  processes writing the same file never see or produce a partially written one.
+ *  @param[in] fname name of the file to write
+ *  @param[in] write function that writes the file contents to the given stream
+ *  @return true on success */
+bool FileSystem::writeFile (const string &fname, const function<bool(ostream&)> &write) {
+	ostringstream oss;
+	oss << fname << '.' << getpid() << ".tmp";
+	string tmpname = oss.str();
+	ofstream ofs(tmpname, ios::binary);
+	bool ok = ofs && write(ofs);
+	ofs.close();
+	if (ok && !ofs.fail()) {
+		if (rename(tmpname, fname))
+			return true;
+#ifdef _WIN32
+		// rename doesn't replace existing files on Windows
+		if (remove(fname) && rename(tmpname, fname))
+			return true;
+#endif
+	}
+	remove(tmpname);
+	return false;
+}
+
+
 uint64_t FileSystem::filesize (const string &fname) {
 #ifdef _WIN32
 	// unfortunately, stat doesn't work properly under Windows
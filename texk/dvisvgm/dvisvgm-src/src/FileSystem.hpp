@@ -21,6 +21,8 @@
 #ifndef FILESYSTEM_HPP
 #define FILESYSTEM_HPP
 
+#include <functional>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -44,6 +46,7 @@ class FileSystem {
 	public:
 		static bool remove (const std::string &fname);
 		static bool rename (const std::string &oldname, const std::string &newname);
+		static bool writeFile (const std::string &fname, const std::function<bool(std::ostream&)> &write);
 		static bool copy (const std::string &src, const std::string &dest, bool remove_src=false);
 		static uint64_t filesize (const std::string &fname);
 		static std::string ensureForwardSlashes (std::string path);
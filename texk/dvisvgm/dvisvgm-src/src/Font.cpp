@@ -20,8 +20,10 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include "CMap.hpp"
 #include "FileFinder.hpp"
 #include "FileSystem.hpp"
@@ -33,6 +35,7 @@
 #include "Subfont.hpp"
 #include "Unicode.hpp"
 #include "utility.hpp"
+#include "XXHashFunction.hpp"
 
 
 using namespace std;
@@ -316,6 +319,43 @@ std::string PhysicalFont::styleName () const {
 
 
 
+/** Returns the name of the cache entry holding the glyph outlines of a vector font.
+ *  Since the outlines are stored per glyph index, they don't depend on the encoding
+ *  or subfont assigned to the font. The name consists of the base name of the font file
+ *  and a hash value computed from the font data, the face index and the style parameters.
+ *  Thus, modified font files and styled variants of a font get separate cache entries.
+ *  @param[in] font vector font to get the cache name for
+ *  @return name of cache entry (empty if the font file can't be read) */
+static const string& outline_cache_name (const PhysicalFont &font) {
+	static unordered_map<string,string> cachenames;  // font descriptor -> cache name
+	const char *path = font.path();
+	ostringstream oss;
+	oss << font.fontIndex();
+	if (const FontStyle *style = font.style()) {
+		oss << setprecision(17) << 'e' << style->extend << 's' << style->slant;
+		if (style->bold != 0)  // emboldening depends on the font size
+			oss << 'b' << style->bold/font.scaledSize();
+	}
+	string variant = oss.str();
+	auto inserted = cachenames.emplace(string(path ? path : "")+"\n"+variant, "");
+	auto it = inserted.first;
+	if (path && inserted.second) {
+		ifstream ifs(path, ios::binary);
+		if (ifs) {
+			XXH64HashFunction hashfunc(variant);
+			hashfunc.update(ifs);
+			string basename = path;
+			size_t pos = basename.find_last_of("/\\");
+			if (pos != string::npos)
+				basename = basename.substr(pos+1);
+			basename = basename.substr(0, basename.rfind('.'));
+			it->second = basename + "-" + hashfunc.digestString();
+		}
+	}
+	return it->second;
+}
+
+
 /** Extracts the glyph outlines of a given character.
  *  @param[in]  c character code of requested glyph
  *  @param[out] glyph path segments of the glyph outline
@@ -353,13 +393,29 @@ bool PhysicalFont::getGlyph (int c, GraphicsPath<int32_t> &glyph, GFGlyphTracer:
 		}
 	}
 	else { // vector fonts (OTF, PFB, TTF, TTC)
-		bool ok=true;
-		FontEngine::instance().setFont(*this);
+		FontEngine &engine = FontEngine::instance();
+		engine.setFont(*this);
 		if (const FontMap::Entry *entry = fontMapEntry())
 			if (Subfont *sf = entry->subfont)
 				c = sf->decode(c);
-		ok = FontEngine::instance().traceOutline(decodeChar(c), glyph, false);
+		int index = engine.charIndex(decodeChar(c));
+		bool cacheable=false;
+		if (!CACHE_PATH.empty()) {
+			const string &cachename = outline_cache_name(*this);
+			if (!cachename.empty()) {
+				_cache.write(CACHE_PATH);
+				_cache.read(cachename, CACHE_PATH);
+				if (const Glyph *cached_glyph = _cache.getGlyph(index)) {
+					glyph = *cached_glyph;
+					return true;
+				}
+				cacheable = true;
+			}
+		}
+		bool ok = engine.traceOutline(Character(Character::INDEX, index), glyph, false);
 		glyph.closeOpenSubPaths();
+		if (ok && cacheable)
+			_cache.setGlyph(index, glyph);
 		return ok;
 	}
 	return false;
@@ -471,6 +527,13 @@ unique_ptr<Font> VirtualFont::create (const string &name, uint32_t checksum, dou
 //////////////////////////////////////////////////////////////////////////////
 
 
+/** Writes the glyphs added to the currently loaded font cache to the cache file. */
+void PhysicalFont::writeCache () {
+	if (!CACHE_PATH.empty())
+		_cache.write(CACHE_PATH);
+}
+
+
 PhysicalFontImpl::PhysicalFontImpl (const string &name, int fontindex, uint32_t cs, double ds, double ss, PhysicalFont::Type type)
 	: TFMFont(name, cs, ds, ss),
 	_filetype(type), _fontIndex(fontindex), _encodingPair(Font::encoding())
@@ -135,9 +135,8 @@ class PhysicalFont : public virtual Font {
 		virtual void setCharMapID (const CharMapID &id) {}
 		virtual Character decodeChar (uint32_t c) const;
 		const char* path () const override;
-
-	protected:
 		bool createGF (std::string &gfname) const;
+		static void writeCache ();
 
 	public:
 		static bool EXACT_BBOX;
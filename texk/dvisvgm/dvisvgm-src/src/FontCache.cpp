@@ -79,8 +79,10 @@ bool FontCache::write (const string &fontname, const string &dir) const {
 	if (!fontname.empty()) {
 		string pathstr = dir.empty() ? FileSystem::getcwd() : dir;
 		pathstr += "/" + fontname + ".fgd";
-		ofstream ofs(pathstr, ios::binary);
-		return write(fontname, ofs);
+		// parallel jobs may write the same cache file
+		return FileSystem::writeFile(pathstr, [&](ostream &os) {
+			return write(fontname, os);
+		});
 	}
 	return false;
 }
@@ -174,6 +176,8 @@ bool FontCache::write (const string &fontname, ostream &os) const {
 	auto digest = hashfunc.digestBytes();
 	sw.writeBytes(digest);  // insert checksum
 	os.seekp(0, ios::end);
+	if (fontname == _fontname)
+		_changed = false;  // prevent rewriting unchanged data on subsequent calls
 	return true;
 }
 
@@ -113,6 +113,15 @@ bool FontEngine::setFont (const Font &font) {
 }
 
 
+/** Closes the current font file. The next call of setFont() opens it again. */
+void FontEngine::releaseFont () {
+	if (_currentFace && FT_Done_Face(_currentFace))
+		Message::estream(true) << "failed to release font\n";
+	_currentFace = nullptr;
+	_currentFont = nullptr;
+}
+
+
 bool FontEngine::isCIDFont() const {
 	FT_Bool cid_keyed;
 	return FT_Get_CID_Is_Internally_CID_Keyed(_currentFace, &cid_keyed) == 0 && cid_keyed;
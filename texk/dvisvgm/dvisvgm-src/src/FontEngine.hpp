@@ -43,8 +43,10 @@ class FontEngine {
 		static FontEngine& instance ();
 		static std::string version ();
 		bool setFont (const Font &font);
+		void releaseFont ();
 		bool isCIDFont() const;
 		bool traceOutline (const Character &c, Glyph &glyph, bool scale=true) const;
+		int charIndex (const Character &c) const;
 		const char* getFamilyName () const;
 		const char* getStyleName () const;
 		int getUnitsPerEM () const;
@@ -70,7 +72,6 @@ class FontEngine {
 	protected:
 		FontEngine ();
 		bool setFont (const std::string &fname, int fontindex, const CharMapID &charmapID);
-		int charIndex (const Character &c) const;
 
 	private:
 		mutable unsigned int _currentChar=0, _currentGlyphIndex=0;
@@ -71,11 +71,14 @@ vector<string> FontWriter::supportedFormats () {
 FontWriter::FontWriter (const PhysicalFont &font) : _font(font) {}
 std::string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {return "";}
 bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {return false;}
+bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, const string &dir, ostream &os, GFGlyphTracer::Callback *cb) const {return false;}
 #else
 #include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
+#include <unordered_map>
 #include <woff2/encode.h>
 #include "ffwrapper.h"
 #include "Bezier.hpp"
@@ -84,6 +87,7 @@ bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes,
 #include "Glyph.hpp"
 #include "TTFAutohint.hpp"
 #include "TrueTypeFont.hpp"
+#include "XXHashFunction.hpp"
 
 
 FontWriter::FontWriter (const PhysicalFont &font) : _font(font) {
@@ -132,13 +136,9 @@ struct SFDActions : Glyph::IterationActions {
 };
 
 
-/** Creates a Spline Font Database (SFD) file describing the font and its glyphs.
+/** Writes a Spline Font Database (SFD) describing the font and its glyphs.
  *  https://fontforge.github.io/sfdformat.html */
-static void writeSFD (const string &sfdname, const PhysicalFont &font, const set<int> &charcodes, GFGlyphTracer::Callback *cb) {
-	ofstream sfd(sfdname);
-	if (!sfd)
-		throw FontWriterException("failed writing SFD file "+sfdname);
-
+static void writeSFD (ostream &sfd, const PhysicalFont &font, const set<int> &charcodes, GFGlyphTracer::Callback *cb) {
 	sfd <<
 		"SplineFontDB: 3.0\n"
 		"FontName: " << font.name() << '\n';
@@ -181,10 +181,6 @@ static void writeSFD (const string &sfdname, const PhysicalFont &font, const set
 			"EndSplineSet\n"
 			"EndChar\n";
 	}
-	sfd.flush();
-	sfd.close();
-	if (sfd.fail())
-		throw FontWriterException("failed writing SFD file "+sfdname);
 }
 
 
@@ -214,39 +210,111 @@ bool FontWriter::createTTFFile (const string &sfdname, const string &ttfname) co
 }
 
 
-/** Creates a font file containing a given set of glyphs mapped to their Unicode points.
+/** Returns the data of a font file containing a given set of glyphs mapped to their Unicode points.
+ *  Since the creation of TrueType and WOFF fonts is expensive, especially the Brotli compression
+ *  of WOFF2 data, the resulting data is kept in memory for the rest of the conversion. If font
+ *  caching is enabled, it's also stored in the cache directory so that following runs can reuse it.
+ *  The data is identified by a hash value computed from the SFD representation of the font subset,
+ *  the target format, and the autohint setting.
  * @param[in] format target font format
  * @param[in] charcodes character codes of the glyphs to be considered
  * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
- * @return name of the created font file */
-string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {
-	string tmpdir = FileSystem::tmpdir();
-	string basename = tmpdir+_font.name()+"-tmp";
+ * @param[out] hash hash value identifying the font data
+ * @return the font data */
+const string& FontWriter::fontData (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb, string &hash) const {
+	static unordered_map<string, string> fontDataMap;  // hash value -> font data
+	const string formatstr = fontFormatInfo(format)->formatstr_short;
+	ostringstream sfd;
+	writeSFD(sfd, _font, charcodes, cb);
+	XXH64HashFunction hashfunc(formatstr);
+	hashfunc.update(AUTOHINT_FONTS ? "ah" : "");
+	hashfunc.update(sfd.str());
+	hash = hashfunc.digestString();
+	auto it = fontDataMap.find(hash);
+	if (it != fontDataMap.end())
+		return it->second;
+
+	string &data = fontDataMap[hash];
+	string cachename;
+	if (!PhysicalFont::CACHE_PATH.empty()) {
+		cachename = PhysicalFont::CACHE_PATH+"/"+_font.name()+"-"+hash+"."+formatstr;
+		ifstream ifs(cachename, ios::binary);
+		if (ifs) {
+			data.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+			if (!data.empty())
+				return data;
+		}
+	}
+	string basename = FileSystem::tmpdir()+_font.name()+"-"+hash;
 	string sfdname = basename+".sfd";
-	writeSFD(sfdname, _font, charcodes, cb);
+	ofstream sfdfile(sfdname);
+	sfdfile << sfd.str();
+	sfdfile.close();
+	if (sfdfile.fail()) {
+		fontDataMap.erase(hash);
+		throw FontWriterException("failed writing SFD file "+sfdname);
+	}
 	string ttfname = basename+".ttf";
-	string targetname = basename+"."+fontFormatInfo(format)->formatstr_short;
+	string targetname = basename+"."+formatstr;
 	bool ok = createTTFFile(sfdname, ttfname);
 	if (ok) {
+		ostringstream oss;
 		if (format == FontFormat::WOFF || format == FontFormat::WOFF2) {
 			TrueTypeFont ttf(ttfname);
 			if (format == FontFormat::WOFF)
-				ttf.writeWOFF(targetname);
+				ttf.writeWOFF(oss);
 			else
-				ok = ttf.writeWOFF2(targetname);
-			if (!PhysicalFont::KEEP_TEMP_FILES)
-				FileSystem::remove(ttfname);
+				ok = ttf.writeWOFF2(oss);
+		}
+		else {
+			ifstream ifs(ttfname, ios::binary);
+			oss << ifs.rdbuf();
 		}
+		data = oss.str();
+		if (PhysicalFont::KEEP_TEMP_FILES) {
+			if (targetname != ttfname) {
+				ofstream ofs(targetname, ios::binary);
+				ofs << data;
+			}
+		}
+		else
+			FileSystem::remove(ttfname);
 	}
 	if (!PhysicalFont::KEEP_TEMP_FILES)
 		FileSystem::remove(sfdname);
-	if (!ok)
+	if (!ok || data.empty()) {
+		fontDataMap.erase(hash);
+		throw FontWriterException("failed writing "+formatstr+" file "+targetname);
+	}
+	if (!cachename.empty()) {
+		// parallel jobs and concurrent runs may store the same font data
+		FileSystem::writeFile(cachename, [&](ostream &os) {
+			return bool(os << data);
+		});
+	}
+	return data;
+}
+
+
+/** Creates a font file containing a given set of glyphs mapped to their Unicode points.
+ * @param[in] format target font format
+ * @param[in] charcodes character codes of the glyphs to be considered
+ * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
+ * @return name of the created font file */
+string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {
+	string hash;
+	const string &data = fontData(format, charcodes, cb, hash);
+	string targetname = FileSystem::tmpdir()+_font.name()+"-tmp."+fontFormatInfo(format)->formatstr_short;
+	ofstream ofs(targetname, ios::binary);
+	ofs << data;
+	ofs.close();
+	if (ofs.fail())
 		throw FontWriterException("failed writing "+string(fontFormatInfo(format)->formatstr_short)+ " file " + targetname);
 	return targetname;
 }
 
 
-/** Writes a CSS font-face rule to an output stream that references or contains the WOFF/TTF font data.
+/** Writes a CSS font-face rule to an output stream that contains the WOFF/TTF font data.
  * @param[in] format target font format
  * @param[in] charcodes character codes of the glyphs to be considered
  * @param[in] os stream the CSS data is written to
@@ -254,19 +322,47 @@ string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes,
  * @return true on success */
 bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {
 	if (const FontFormatInfo *info = fontFormatInfo(format)) {
-		string filename = createFontFile(format, charcodes, cb);
-		ifstream ifs(filename, ios::binary);
-		if (ifs) {
-			os << "@font-face{"
-				<< "font-family:" << _font.name() << ';'
-				<< "src:url(data:" << info->mimetype << ";base64,";
-			util::base64_copy(ifs, os);
-			os << ") format('" << info->formatstr_long << "');}\n";
-			ifs.close();
-			if (!PhysicalFont::KEEP_TEMP_FILES)
-				FileSystem::remove(filename);
-			return true;
+		string hash;
+		const string &data = fontData(format, charcodes, cb, hash);
+		os << "@font-face{"
+			<< "font-family:" << _font.name() << ';'
+			<< "src:url(data:" << info->mimetype << ";base64,";
+		util::base64_copy(data.begin(), data.end(), ostreambuf_iterator<char>(os));
+		os << ") format('" << info->formatstr_long << "');}\n";
+		return true;
+	}
+	return false;
+}
+
+
+/** Writes a CSS font-face rule to an output stream that references a separate WOFF/TTF font file.
+ *  The file is named after the font and the hash value of its data, and it's only written if it
+ *  doesn't exist yet. Thus, all SVG files placed in the same directory share identical font subsets.
+ *  Since parallel jobs may create the same file at the same time, it's written to a temporary file
+ *  first that is renamed afterwards.
+ * @param[in] format target font format
+ * @param[in] charcodes character codes of the glyphs to be considered
+ * @param[in] dir directory where the font file is stored (usually the one of the SVG file)
+ * @param[in] os stream the CSS data is written to
+ * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
+ * @return true on success */
+bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, const string &dir, ostream &os, GFGlyphTracer::Callback *cb) const {
+	if (const FontFormatInfo *info = fontFormatInfo(format)) {
+		string hash;
+		const string &data = fontData(format, charcodes, cb, hash);
+		string fname = _font.name()+"-"+hash+"."+info->formatstr_short;
+		string path = dir.empty() ? fname : dir+"/"+fname;
+		if (!FileSystem::exists(path)) {
+			bool written = FileSystem::writeFile(path, [&](ostream &os) {
+				return bool(os << data);
+			});
+			if (!written)
+				throw FontWriterException("failed writing font file "+path);
 		}
+		os << "@font-face{"
+			<< "font-family:" << _font.name() << ';'
+			<< "src:url(" << fname << ") format('" << info->formatstr_long << "');}\n";
+		return true;
 	}
 	return false;
 }
@@ -39,6 +39,7 @@ class FontWriter {
 		explicit FontWriter (const PhysicalFont &font);
 		std::string createFontFile (FontFormat format, const std::set<int> &charcodes, GFGlyphTracer::Callback *cb=nullptr) const;
 		bool writeCSSFontFace (FontFormat format, const std::set<int> &charcodes, std::ostream &os, GFGlyphTracer::Callback *cb=nullptr) const;
+		bool writeCSSFontFace (FontFormat format, const std::set<int> &charcodes, const std::string &dir, std::ostream &os, GFGlyphTracer::Callback *cb=nullptr) const;
 		static FontFormat toFontFormat (std::string formatstr);
 		static std::vector<std::string> supportedFormats ();
 
@@ -51,6 +52,7 @@ class FontWriter {
 		};
 		static const FontFormatInfo* fontFormatInfo (FontFormat format);
 		bool createTTFFile (const std::string &sfdname, const std::string &ttfname) const;
+		const std::string& fontData (FontFormat format, const std::set<int> &charcodes, GFGlyphTracer::Callback *cb, std::string &hash) const;
 
 	private:
 		const PhysicalFont &_font;
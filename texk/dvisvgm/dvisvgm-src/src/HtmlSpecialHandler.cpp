@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include "HtmlSpecialHandler.hpp"
 #include "HyperlinkManager.hpp"
 #include "InputReader.hpp"
@@ -38,6 +39,17 @@ void HtmlSpecialHandler::preprocess (const string&, istream &is, SpecialActions
 		else if ((it = attribs.find("href")) != attribs.end())
 			HyperlinkManager::instance().addHrefAnchor(it->second);
 	}
+	// collect the base URLs so that they can be restored for any page
+	else if (ir.check("<base ") && ir.parseAttributes(attribs, true, "\"") > 0) {
+		auto it = attribs.find("href");
+		if (it != attribs.end()) {
+			unsigned pageno = actions.getCurrentPageNumber();
+			if (!_pageBaseUrls.empty() && _pageBaseUrls.back().first == pageno)
+				_pageBaseUrls.back().second = it->second;
+			else
+				_pageBaseUrls.emplace_back(pageno, it->second);
+		}
+	}
 }
 
 
@@ -72,6 +84,19 @@ void HtmlSpecialHandler::dviMovedTo (double x, double y, SpecialActions &actions
 }
 
 
+/** Restores the base URL set by the preceding pages, which only differs from the
+ *  current one if the preceding page hasn't been converted right before. */
+void HtmlSpecialHandler::dviBeginPage (unsigned pageno, SpecialActions &actions) {
+	auto it = lower_bound(_pageBaseUrls.begin(), _pageBaseUrls.end(), pageno,
+		[](const PageBaseUrl &pbu, unsigned pageno) {return pbu.first < pageno;});
+	string base;
+	if (it != _pageBaseUrls.begin())
+		base = (--it)->second;
+	if (base != HyperlinkManager::instance().baseUrl())
+		HyperlinkManager::instance().setBaseUrl(base);
+}
+
+
 void HtmlSpecialHandler::dviEndPage (unsigned pageno, SpecialActions &actions) {
 	if (_active) {
 		HyperlinkManager::instance().createViews(pageno, actions);
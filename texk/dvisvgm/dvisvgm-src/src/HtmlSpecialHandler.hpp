@@ -22,6 +22,8 @@
 #define HTMLSPECIALHANDLER_HPP
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "Color.hpp"
 #include "SpecialHandler.hpp"
 
@@ -36,11 +38,14 @@ class HtmlSpecialHandler : public SpecialHandler {
 		std::vector<const char*> prefixes() const override;
 
 	protected:
+		void dviBeginPage (unsigned pageno, SpecialActions &actions) override;
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
 		void dviMovedTo (double x, double y, SpecialActions &actions) override;
 
 	private:
+		using PageBaseUrl = std::pair<unsigned,std::string>;  // page number and base URL
 		bool _active=false;
+		std::vector<PageBaseUrl> _pageBaseUrls;  ///< base URLs set on the pages
 };
 
 #endif
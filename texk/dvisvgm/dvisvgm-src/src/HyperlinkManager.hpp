@@ -53,6 +53,7 @@ class HyperlinkManager {
 		void createLink (std::string uri, SpecialActions &actions);
 		void createViews (unsigned pageno, SpecialActions &actions);
 		void setBaseUrl (std::string &base) {_base = base;}
+		const std::string& baseUrl () const {return _base;}
 		void setLineWidth (double w) {_linewidth = w;}
 		static HyperlinkManager& instance ();
 		static bool setLinkMarker (const std::string &marker);
@@ -19,10 +19,14 @@
 *************************************************************************/
 
 #include <array>
+#include <cctype>
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <memory>
 #include <sstream>
+#include <unordered_set>
 #include "FileFinder.hpp"
 #include "FilePath.hpp"
 #include "FileSystem.hpp"
@@ -36,6 +40,7 @@
 #include "TensorProductPatch.hpp"
 #include "TriangularPatch.hpp"
 #include "utility.hpp"
+#include "XMLNode.hpp"
 
 using namespace std;
 
@@ -45,6 +50,7 @@ bool PsSpecialHandler::SHADING_SEGMENT_OVERLAP = false;
 int PsSpecialHandler::SHADING_SEGMENT_SIZE = 20;
 double PsSpecialHandler::SHADING_SIMPLIFY_DELTA = 0.01;
 string PsSpecialHandler::BITMAP_FORMAT;
+bool PsSpecialHandler::REPLAY_LITERALS = false;
 
 
 PsSpecialHandler::PsSpecialHandler () : _psi(this), _previewFilter(_psi)
@@ -144,19 +150,24 @@ void PsSpecialHandler::moveToDVIPos () {
 }
 
 
-/** Executes a PS snippet and optionally synchronizes the DVI cursor position
- *  with the current PS point.
- *  @param[in] is  stream to read the PS code from
- *  @param[in] updatePos if true, move the DVI drawing position to the current PS point */
-void PsSpecialHandler::executeAndSync (istream &is, bool updatePos) {
+/** Updates the PS graphics state if the color has been changed by a color special. */
+void PsSpecialHandler::syncColor () {
 	if (_actions && _actions->getColor() != _currentcolor) {
-		// update the PS graphics state if the color has been changed by a color special
 		double r, g, b;
 		_actions->getColor().getRGB(r, g, b);
 		ostringstream oss;
 		oss << '\n' << r << ' ' << g << ' ' << b << " setrgbcolor ";
 		_psi.execute(oss.str(), false);
 	}
+}
+
+
+/** Executes a PS snippet and optionally synchronizes the DVI cursor position
+ *  with the current PS point.
+ *  @param[in] is  stream to read the PS code from
+ *  @param[in] updatePos if true, move the DVI drawing position to the current PS point */
+void PsSpecialHandler::executeAndSync (istream &is, bool updatePos) {
+	syncColor();
 	_psi.execute(is);
 	if (updatePos) {
 		// retrieve current PS position (stored in _currentpoint)
@@ -169,7 +180,255 @@ void PsSpecialHandler::executeAndSync (istream &is, bool updatePos) {
 }
 
 
+/** Writes the state parameters to a stream (used to build the lookup keys of recorded specials). */
+void PsSpecialHandler::GraphicsState::write (ostream &os) const {
+	os << uint32_t(color) << ' ' << uint32_t(currentcolor);
+	for (int row=0; row < 2; row++)
+		for (int col=0; col < 3; col++)
+			os << ' ' << matrix.get(row, col);
+	os << ' ' << sx << ' ' << sy << ' ' << cos
+		<< ' ' << linewidth << ' ' << miterlimit << ' ' << isshapealpha
+		<< ' ' << fillalpha[0] << ' ' << fillalpha[1]
+		<< ' ' << strokealpha[0] << ' ' << strokealpha[1]
+		<< ' ' << blendmode << ' ' << int(linecap) << ' ' << int(linejoin)
+		<< ' ' << dashoffset << ' ' << dashpattern.size();
+	for (double dash : dashpattern)
+		os << ' ' << dash;
+	os << ' ' << patternEnabled;
+}
+
+
+/** Returns true if a PS token is a number, e.g. 12, -.5, 1e-3, or 16#FF. */
+static bool is_ps_number (const string &token) {
+	size_t pos = token.find('#');
+	if (pos != string::npos) {
+		if (pos == 0 || pos > 2 || pos+1 == token.length() || !isdigit(token[0]) || !isdigit(token[pos-1]))
+			return false;
+		int radix = stoi(token.substr(0, pos));
+		if (radix < 2 || radix > 36)
+			return false;
+		for (size_t i=pos+1; i < token.length(); i++) {
+			int c = tolower(token[i]);
+			int digit = isdigit(c) ? c-'0' : (c >= 'a' && c <= 'z' ? c-'a'+10 : 36);
+			if (digit >= radix)
+				return false;
+		}
+		return true;
+	}
+	if (token.empty() || token.find_first_not_of("0123456789+-.eE") != string::npos)
+		return false;
+	char *endptr;
+	strtod(token.c_str(), &endptr);
+	return *endptr == 0 && token.find_first_of("0123456789") < token.find_first_of("eE");
+}
+
+
+/** Returns true if the given PS code can only depend on the graphics state and
+ *  the operands it pushes itself. This is the case if all executable names are
+ *  operators that neither access dictionaries other than the ones created by the
+ *  code nor change the VM, the fonts, or other state not tracked by the handler.
+ *  Since the code can't refer to definitions made by other specials or headers,
+ *  and can't make any that outlast the enclosing save/restore pair, its output
+ *  may be replayed.
+ *  @param[in] code PS code to check
+ *  @return true if the code is self-contained */
+bool PsSpecialHandler::isSelfContained (const string &code) {
+	static const unordered_set<string> operators = {
+		"[", "]", "<<", ">>",
+		"pop", "exch", "dup", "copy", "index", "roll", "clear", "count", "mark", "cleartomark", "counttomark",
+		"add", "sub", "mul", "div", "idiv", "mod", "abs", "neg", "ceiling", "floor", "round", "truncate",
+		"sqrt", "atan", "cos", "sin", "exp", "ln", "log", "cvi", "cvr", "bitshift",
+		"eq", "ne", "ge", "gt", "le", "lt", "and", "or", "xor", "not", "true", "false",
+		"if", "ifelse", "for", "repeat", "loop", "exit", "exec", "forall",
+		"array", "dict", "string", "length", "get", "put", "getinterval", "putinterval", "aload", "astore",
+		"begin", "end", "def",
+		"newpath", "moveto", "rmoveto", "lineto", "rlineto", "curveto", "rcurveto",
+		"arc", "arcn", "arct", "arcto", "closepath", "currentpoint",
+		"stroke", "fill", "eofill", "rectfill", "rectstroke", "gsave", "grestore",
+		"setlinewidth", "setlinecap", "setlinejoin", "setmiterlimit", "setdash", "currentlinewidth",
+		"setgray", "setrgbcolor", "setcmykcolor", "sethsbcolor",
+		"translate", "scale", "rotate", "concat", "matrix", "currentmatrix", "setmatrix",
+		"transform", "itransform", "dtransform", "idtransform", "concatmatrix", "invertmatrix", "identmatrix"
+	};
+	auto is_delim = [](char c) {
+		return isspace(c) || c == 0 || strchr("()<>[]{}/%", c);
+	};
+	size_t pos=0;
+	while (pos < code.length()) {
+		char c = code[pos];
+		if (isspace(c) || c == 0 || c == '{' || c == '}')
+			pos++;
+		else if (c == '%')
+			pos = min(code.find_first_of("\r\n", pos), code.length());
+		else if (c == '(') {  // string, possibly with balanced parentheses
+			int level=0;
+			for (; pos < code.length(); pos++) {
+				if (code[pos] == '\\')
+					pos++;
+				else if (code[pos] == '(')
+					level++;
+				else if (code[pos] == ')' && --level == 0)
+					break;
+			}
+			if (pos++ >= code.length())
+				return false;
+		}
+		else if (code.compare(pos, 2, "<<") == 0 || code.compare(pos, 2, ">>") == 0)
+			pos += 2;
+		else if (c == '<') {  // hex or ASCII85 string
+			pos = code.find(code.compare(pos, 2, "<~") == 0 ? "~>" : ">", pos+1);
+			if (pos == string::npos)
+				return false;
+			pos++;
+		}
+		else if (c == '[' || c == ']')
+			pos++;
+		else if (c == ')' || c == '>')
+			return false;
+		else {
+			bool literal = (c == '/');
+			if (literal && pos+1 < code.length() && code[pos+1] == '/')
+				return false;  // immediately evaluated name
+			size_t start = literal ? pos+1 : pos;
+			for (pos=start; pos < code.length() && !is_delim(code[pos]); pos++);
+			if (literal)
+				continue;
+			string token = code.substr(start, pos-start);
+			if (operators.find(token) != operators.end())
+				continue;
+			if (!is_ps_number(token))
+				return false;
+		}
+	}
+	return true;
+}
+
+
+/** Executes a literal PS special isolated by a wrapping save/restore pair.
+ *  If REPLAY_LITERALS is true, the SVG elements created by a self-contained special
+ *  are recorded together with the resulting graphics state. When the same PS code
+ *  is executed again at the same position, with the same graphics state, and no
+ *  other PS code has been executed in between that might have changed the definitions
+ *  visible to it, the recorded output is replayed instead of running the code again.
+ *  Specials that create clipping paths, patterns, shadings, or bitmaps are not recorded
+ *  because they depend on definitions local to the current page.
+ *  @param[in] is stream to read the PS code from */
+void PsSpecialHandler::executeLiteral (istream &is) {
+	bool replay = REPLAY_LITERALS && _actions && !_xmlnode && !_clipStack.path();
+	string code;
+	if (replay) {
+		code.assign(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+		replay = isSelfContained(code);
+	}
+	if (!replay) {
+		// the code may change definitions other specials rely on, e.g. in global VM
+		_vmGeneration++;
+		_psi.execute("\n@beginspecial @setspecial ");
+		if (code.empty())
+			executeAndSync(is, false);
+		else {
+			syncColor();
+			_psi.execute(code.data(), code.length());
+		}
+		_psi.execute("\n@endspecial ");
+		return;
+	}
+	syncColor();
+	ostringstream oss;
+	oss << setprecision(17) << _vmGeneration << ' ' << _currentpoint.x() << ' ' << _currentpoint.y() << ' ' << _actions->outputLocked() << ' ';
+	graphicsState().write(oss);
+	oss << '\n' << code;
+	string key = oss.str();
+	auto it = _literalOutputs.find(key);
+	if (it != _literalOutputs.end()) {
+		const LiteralOutput &output = *it->second;
+		for (const auto &node : output.nodes)
+			_actions->svgTree().appendToPage(node->clone());
+		_actions->embed(output.bbox);
+		setGraphicsState(output.state);
+		return;
+	}
+	auto output = util::make_unique<LiteralOutput>();
+	_recording = output.get();
+	try {
+		_psi.execute("\n@beginspecial @setspecial ");
+		_psi.execute(code.data(), code.length());
+		_psi.execute("\n@endspecial ");
+	}
+	catch (...) {
+		_recording = nullptr;
+		throw;
+	}
+	_recording = nullptr;
+	if (output->replayable) {
+		output->state = graphicsState();
+		_literalOutputs.emplace(std::move(key), std::move(output));
+	}
+}
+
+
+/** Appends an element to the current page and embeds its bounding box. If the output
+ *  of a literal special is being recorded, a copy of the element is kept for replaying. */
+void PsSpecialHandler::appendToPage (unique_ptr<XMLElement> node, const BoundingBox &bbox) {
+	if (_recording) {
+		if (node)
+			_recording->nodes.push_back(node->clone());
+		_recording->bbox.embed(bbox);
+	}
+	_actions->svgTree().appendToPage(std::move(node));
+	_actions->embed(bbox);
+}
+
+
+PsSpecialHandler::GraphicsState PsSpecialHandler::graphicsState () const {
+	GraphicsState state;
+	state.color = _actions->getColor();
+	state.currentcolor = _currentcolor;
+	state.matrix = _actions->getMatrix();
+	state.sx = _sx;
+	state.sy = _sy;
+	state.cos = _cos;
+	state.linewidth = _linewidth;
+	state.miterlimit = _miterlimit;
+	state.isshapealpha = _isshapealpha;
+	state.fillalpha = _fillalpha;
+	state.strokealpha = _strokealpha;
+	state.blendmode = _blendmode;
+	state.linecap = _linecap;
+	state.linejoin = _linejoin;
+	state.dashoffset = _dashoffset;
+	state.dashpattern = _dashpattern;
+	state.patternEnabled = _patternEnabled;
+	return state;
+}
+
+
+void PsSpecialHandler::setGraphicsState (const GraphicsState &state) {
+	_actions->setColor(state.color);
+	_currentcolor = state.currentcolor;
+	_actions->setMatrix(state.matrix);
+	_sx = state.sx;
+	_sy = state.sy;
+	_cos = state.cos;
+	_linewidth = state.linewidth;
+	_miterlimit = state.miterlimit;
+	_isshapealpha = state.isshapealpha;
+	_fillalpha = state.fillalpha;
+	_strokealpha = state.strokealpha;
+	_blendmode = state.blendmode;
+	_linecap = state.linecap;
+	_linejoin = state.linejoin;
+	_dashoffset = state.dashoffset;
+	_dashpattern = state.dashpattern;
+	_patternEnabled = state.patternEnabled;
+}
+
+
 void PsSpecialHandler::preprocess (const string &prefix, istream &is, SpecialActions &actions) {
+	// Literal PS code not isolated by save/restore can leave definitions and graphics
+	// state behind that later pages rely on.
+	if (prefix == "ps:" || prefix == "ps::" || prefix == "PST:")
+		_pageLiterals = true;
 	initialize();
 	if (_psSection != PS_HEADERS)
 		return;
@@ -210,11 +469,12 @@ bool PsSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 	if (prefix == "\"" || prefix == "pst:") {
 		// read and execute literal PostScript code (isolated by a wrapping save/restore pair)
 		moveToDVIPos();
-		_psi.execute("\n@beginspecial @setspecial ");
-		executeAndSync(is, false);
-		_psi.execute("\n@endspecial ");
+		executeLiteral(is);
+		return true;
 	}
-	else if (prefix == "psfile=" || prefix == "PSfile=" || prefix == "pdffile=") {
+	// the remaining specials may change definitions seen by literal specials
+	_vmGeneration++;
+	if (prefix == "psfile=" || prefix == "PSfile=" || prefix == "pdffile=") {
 		if (_actions) {
 			StreamInputReader in(is);
 			string fname = in.getQuotedString(in.peek() == '"' ? "\"" : nullptr);
@@ -553,6 +813,7 @@ void PsSpecialHandler::dviEndPage (unsigned, SpecialActions &actions) {
 ///////////////////////////////////////////////////////
 
 void PsSpecialHandler::setpagedevice (std::vector<double> &p) {
+	cancelReplay();
 	_linewidth = 1;
 	_linecap = _linejoin = 0;  // butt end caps and miter joins
 	_miterlimit = 4;
@@ -579,6 +840,7 @@ void PsSpecialHandler::grestore (vector<double>&) {
 
 
 void PsSpecialHandler::grestoreall (vector<double>&) {
+	cancelReplay();
 	_clipStack.pop(-1, true);
 }
 
@@ -692,13 +954,14 @@ void PsSpecialHandler::stroke (vector<double> &p) {
 		path->addAttribute("clip-path", XMLString("url(#clip")+XMLString(_clipStack.topID())+")");
 		bbox.intersect(_clipStack.path()->computeBBox());
 		_clipStack.removePrependedPath();
+		cancelReplay();  // the clipping path is defined on the current page only
 	}
-	if (_xmlnode)
+	if (_xmlnode) {
 		_xmlnode->append(std::move(path));
-	else {
-		_actions->svgTree().appendToPage(std::move(path));
-		_actions->embed(bbox);
+		cancelReplay();
 	}
+	else
+		appendToPage(std::move(path), bbox);
 	_path.clear();
 }
 
@@ -725,8 +988,10 @@ void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
 	_path.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS);
 	unique_ptr<XMLElement> path = util::make_unique<XMLElement>("path");
 	path->addAttribute("d", oss.str());
-	if (_pattern)
+	if (_pattern) {
 		path->addAttribute("fill", XMLString("url(#")+_pattern->svgID()+")");
+		cancelReplay();  // the pattern is defined on the current page only
+	}
 	else if (_actions->getColor() != Color::BLACK || _savenode)
 		path->addAttribute("fill", _actions->getColor().svgColorString());
 	if (_clipStack.path() && !_savenode) {  // clip path active and not inside pattern definition?
@@ -734,6 +999,7 @@ void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
 		path->addAttribute("clip-path", XMLString("url(#clip")+XMLString(_clipStack.topID())+")");
 		bbox.intersect(_clipStack.path()->computeBBox());
 		_clipStack.removePrependedPath();
+		cancelReplay();  // the clipping path is defined on the current page only
 	}
 	if (evenodd)  // SVG default fill rule is "nonzero" algorithm
 		path->addAttribute("fill-rule", "evenodd");
@@ -741,12 +1007,12 @@ void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
 		path->addAttribute("fill-opacity", _fillalpha[0] * _fillalpha[1]);
 	if (_blendmode > 0 && _blendmode < 16)
 		path->addAttribute("style", "mix-blend-mode:"+css_blendmode_name(_blendmode));
-	if (_xmlnode)
+	if (_xmlnode) {
 		_xmlnode->append(std::move(path));
-	else {
-		_actions->svgTree().appendToPage(std::move(path));
-		_actions->embed(bbox);
+		cancelReplay();
 	}
+	else
+		appendToPage(std::move(path), bbox);
 	_path.clear();
 }
 
@@ -755,6 +1021,7 @@ void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
  *  the PS image operator succeeded, there's now a PNG file that must be embedded
  *  into the SVG file. */
 void PsSpecialHandler::image (std::vector<double> &p) {
+	cancelReplay();
 	int imgID = static_cast<int>(p[0]);   // ID of PNG file written
 	if (imgID < 0)  // no bitmap file written?
 		return;
@@ -842,6 +1109,7 @@ static void create_matrix (vector<double> &v, int startindex, Matrix &matrix) {
  *  8: paint type (1: colored pattern, 2: uncolored pattern)
  *  9-14: pattern matrix */
 void PsSpecialHandler::makepattern (vector<double> &p) {
+	cancelReplay();
 	int pattern_type = static_cast<int>(p[0]);
 	switch (pattern_type) {
 		case 0:
@@ -883,6 +1151,7 @@ void PsSpecialHandler::makepattern (vector<double> &p) {
  *  1-3: (optional) RGB values for uncolored tiling patterns
  *  further parameters depend on the pattern type */
 void PsSpecialHandler::setpattern (vector<double> &p) {
+	cancelReplay();
 	int patternID = static_cast<int>(p[0]);
 	Color color;
 	if (p.size() == 4)
@@ -905,12 +1174,14 @@ void PsSpecialHandler::setpattern (vector<double> &p) {
 /** Clears the current clipping path.
  *  @param[in] p not used */
 void PsSpecialHandler::initclip (vector<double> &) {
+	cancelReplay();
 	_clipStack.pushEmptyPath();
 }
 
 
 /** Assigns the current clipping path to the graphics path. */
 void PsSpecialHandler::clippath (std::vector<double>&) {
+	cancelReplay();
 	if (!_clipStack.empty())
 		_clipStack.setPrependedPath();
 }
@@ -933,6 +1204,7 @@ void PsSpecialHandler::clip (vector<double>&, bool evenodd) {
  *  @param[in] path path used to restrict the clipping region
  *  @param[in] evenodd true: use even-odd fill algorithm, false: use nonzero fill algorithm */
 void PsSpecialHandler::clip (Path path, bool evenodd) {
+	cancelReplay();
 	// when this method is called, _path contains the clipping path
 	if (path.empty() || !_actions)
 		return;
@@ -986,6 +1258,7 @@ void PsSpecialHandler::clip (Path path, bool evenodd) {
  *  - 1.0 followed by the bounding box coordinates, or 0.0
  *  - geometry and color parameters depending on the shading type */
 void PsSpecialHandler::shfill (vector<double> &params) {
+	cancelReplay();
 	if (params.size() < 9)
 		return;
 
@@ -1306,6 +1579,7 @@ void PsSpecialHandler::executed () {
 /** This method is called by PSInterpreter if the status of the output devices has changed.
  *  @param[in] p 1 if output device is the nulldevice, 1 otherwise */
 void PsSpecialHandler::setnulldevice (vector<double> &p) {
+	cancelReplay();
 	if (_actions) {
 		if (p[0] != 0)
 			_actions->lockOutput();   // prevent further SVG output
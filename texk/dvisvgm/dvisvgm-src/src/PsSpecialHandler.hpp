@@ -25,8 +25,11 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "BoundingBox.hpp"
 #include "GraphicsPath.hpp"
+#include "Matrix.hpp"
 #include "PSInterpreter.hpp"
 #include "SpecialHandler.hpp"
 #include "PSPattern.hpp"
@@ -35,6 +38,7 @@
 
 class PSPattern;
 class XMLElement;
+class XMLNode;
 
 class PsSpecialHandler : public SpecialHandler, protected PSActions {
 	using Path = GraphicsPath<double>;
@@ -75,6 +79,32 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 			std::stack<Entry> _stack;  ///< stack holding the clipping information of the current graphics context
 	};
 
+	/** Graphics state parameters tracked by the handler. */
+	struct GraphicsState {
+		Color color;           ///< current color of the DVI actions
+		Color currentcolor;
+		Matrix matrix;         ///< current transformation matrix of the DVI actions
+		double sx, sy, cos;
+		double linewidth, miterlimit;
+		bool isshapealpha;
+		std::array<double,2> fillalpha, strokealpha;
+		int blendmode;
+		uint8_t linecap, linejoin;
+		double dashoffset;
+		std::vector<double> dashpattern;
+		bool patternEnabled;
+		void write (std::ostream &os) const;
+	};
+
+	/** SVG output and resulting graphics state of a literal PS special. It's
+	 *  replayed if the special is executed again in the same context. */
+	struct LiteralOutput {
+		std::vector<std::unique_ptr<XMLNode>> nodes;  ///< elements appended to the page
+		BoundingBox bbox;      ///< extent of the appended elements
+		GraphicsState state;   ///< graphics state after executing the special
+		bool replayable=true;  ///< false if the special has effects that can't be replayed
+	};
+
 	enum PsSection {PS_NONE, PS_HEADERS, PS_BODY};
 	enum class FileType {EPS, PDF, SVG, BITMAP};
 
@@ -89,6 +119,7 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		void setDviScaleFactor (double dvi2bp) override {_previewFilter.setDviScaleFactor(dvi2bp);}
 		void enterBodySection ();
 		PSInterpreter& psInterpreter () {return _psi;}
+		static bool isSelfContained (const std::string &code);
 
 	public:
 		static bool COMPUTE_CLIPPATHS_INTERSECTIONS;
@@ -96,17 +127,25 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		static int SHADING_SEGMENT_SIZE;
 		static double SHADING_SIMPLIFY_DELTA;
 		static std::string BITMAP_FORMAT;
+		static bool REPLAY_LITERALS;
 
 	protected:
 		void initialize ();
 		void initgraphics ();
 		void moveToDVIPos ();
+		void syncColor ();
 		void executeAndSync (std::istream &is, bool updatePos);
+		void executeLiteral (std::istream &is);
+		void appendToPage (std::unique_ptr<XMLElement> node, const BoundingBox &bbox);
+		void cancelReplay () {if (_recording) _recording->replayable = false;}
+		GraphicsState graphicsState () const;
+		void setGraphicsState (const GraphicsState &state);
 		void processHeaderFile (const char *fname);
 		void imgfile (FileType type, const std::string &fname, const std::map<std::string,std::string> &attr);
 		std::unique_ptr<XMLElement> createImageNode (FileType type, const std::string &fname, int pageno, BoundingBox bbox, bool clip);
 		void dviBeginPage (unsigned int pageno, SpecialActions &actions) override;
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
+		bool carriesPageState () const override {return _pageLiterals;}
 		void clip (Path path, bool evenodd);
 		void processSequentialPatchMesh (int shadingTypeID, ColorSpace cspace, VectorIterator<double> &it);
 		void processLatticeTriangularPatchMesh (ColorSpace colorSpace, VectorIterator<double> &it);
@@ -169,6 +208,7 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		XMLElement *_xmlnode=nullptr;      ///< if != 0, created SVG elements are appended to this node
 		XMLElement *_savenode=nullptr;     ///< pointer to temporaryly store _xmlnode
 		std::string _headerCode;           ///< collected literal PS header code
+		bool _pageLiterals=false;          ///< true if the pages contain literal PS code that isn't isolated
 		Path _path;
 		DPair _currentpoint;               ///< current PS position in bp units
 		Color _currentcolor;               ///< current stroke/fill color
@@ -188,6 +228,9 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		std::map<int, std::unique_ptr<PSPattern>> _patterns;
 		PSTilingPattern *_pattern;         ///< current pattern
 		bool _patternEnabled;              ///< true if active color space is a pattern
+		std::unordered_map<std::string, std::unique_ptr<LiteralOutput>> _literalOutputs;  ///< replayable output of literal specials
+		LiteralOutput *_recording=nullptr; ///< output of the literal special currently executed
+		unsigned _vmGeneration=0;          ///< changes whenever PS code is executed that may alter the VM state
 };
 
 #endif
@@ -171,6 +171,15 @@ string SVGOutput::expandFormatString (string str, int page, int numPages, const
 }
 
 
+/** Flushes and closes the stream of the page currently being written. */
+void SVGOutput::finish () const {
+	if (_osptr)
+		_osptr->flush();
+	_osptr.reset();
+	_page = -1;
+}
+
+
 /** Returns true if methods 'filename' and 'getPageStream' ignore the hash
  *  parameter because it's not requested in the filename pattern. */
 bool SVGOutput::ignoresHashes () const {
@@ -48,6 +48,7 @@ struct SVGOutputBase {
 	virtual std::ostream& getPageStream (int page, int numPages, const HashTriple &hashes=HashTriple()) const =0;
 	virtual FilePath filepath (int page, int numPages, const HashTriple &hashes= HashTriple()) const =0;
 	virtual bool ignoresHashes () const {return true;}
+	virtual void finish () const {}
 };
 
 
@@ -60,6 +61,7 @@ class SVGOutput : public SVGOutputBase {
 		std::ostream& getPageStream (int page, int numPages, const HashTriple &hash=HashTriple()) const override;
 		FilePath filepath (int page, int numPages, const HashTriple &hash=HashTriple()) const override;
 		bool ignoresHashes () const override;
+		void finish () const override;
 
 	protected:
 		std::string expandFormatString (std::string str, int page, int numPages, const HashTriple &hashes) const;
@@ -40,11 +40,13 @@ using namespace std;
 bool SVGTree::CREATE_CSS=true;
 bool SVGTree::USE_FONTS=true;
 FontWriter::FontFormat SVGTree::FONT_FORMAT = FontWriter::FontFormat::SVG;
+bool SVGTree::LINK_FONTS=false;
 bool SVGTree::CREATE_USE_ELEMENTS=false;
 bool SVGTree::RELATIVE_PATH_CMDS=false;
 bool SVGTree::MERGE_CHARS=true;
 bool SVGTree::ADD_COMMENTS=false;
 double SVGTree::ZOOM_FACTOR=1.0;
+bool SVGTree::STREAM_PAGES=false;
 
 
 SVGTree::SVGTree () : _charHandler(SVGCharHandlerFactory::createHandler()) {
@@ -63,6 +65,8 @@ void SVGTree::reset () {
 	_doc.setRootNode(std::move(rootNode));
 	_page = _defs = nullptr;
 	_styleCDataNode = nullptr;
+	_flushMark = nullptr;
+	_flushBlocked = false;
 }
 
 
@@ -93,17 +97,19 @@ void SVGTree::setFont (int num, const Font &font) {
 
 
 bool SVGTree::setFontFormat (string formatstr) {
-	size_t pos = formatstr.find(',');
-	string opt;
-	if (pos != string::npos) {
-		opt = formatstr.substr(pos+1);
-		formatstr = formatstr.substr(0, pos);
-	}
-	FontWriter::FontFormat format = FontWriter::toFontFormat(formatstr);
+	vector<string> opts = util::split(formatstr, ",");
+	FontWriter::FontFormat format = FontWriter::toFontFormat(opts[0]);
 	if (format == FontWriter::FontFormat::UNKNOWN)
 		return false;
 	FONT_FORMAT = format;
-	FontWriter::AUTOHINT_FONTS = (opt == "autohint" || opt == "ah");
+	FontWriter::AUTOHINT_FONTS = false;
+	LINK_FONTS = false;
+	for (size_t i=1; i < opts.size(); i++) {
+		if (opts[i] == "autohint" || opts[i] == "ah")
+			FontWriter::AUTOHINT_FONTS = true;
+		else if (opts[i] == "link")
+			LINK_FONTS = true;
+	}
 	return true;
 }
 
@@ -119,6 +125,8 @@ void SVGTree::newPage (int pageno) {
 	_root->append(std::move(pageNode));
 	_defsContextStack = stack<XMLElement*>();
 	_pageContextStack = stack<XMLElement*>();
+	_flushMark = nullptr;
+	_flushBlocked = false;
 }
 
 
@@ -134,6 +142,7 @@ void SVGTree::appendToDefs (unique_ptr<XMLNode> node) {
 
 
 void SVGTree::appendToPage (unique_ptr<XMLNode> node) {
+	flushPage();
 	XMLElement *parent = _pageContextStack.empty() ? _page : _pageContextStack.top();
 	parent->append(std::move(node));
 	_charHandler->setInitialContextNode(parent);
@@ -248,7 +257,12 @@ void SVGTree::append (const PhysicalFont &font, const set<int> &chars, GFGlyphTr
 		if (FONT_FORMAT != FontWriter::FontFormat::SVG) {
 			ostringstream style;
 			FontWriter fontWriter(font);
-			if (fontWriter.writeCSSFontFace(FONT_FORMAT, chars, style, callback))
+			bool written;
+			if (LINK_FONTS && !_fontFileDir.empty())
+				written = fontWriter.writeCSSFontFace(FONT_FORMAT, chars, _fontFileDir, style, callback);
+			else
+				written = fontWriter.writeCSSFontFace(FONT_FORMAT, chars, style, callback);
+			if (written)
 				styleCDataNode()->append(style.str());
 		}
 		else {
@@ -316,6 +330,7 @@ void SVGTree::popDefsContext () {
 /** Pushes a new context element that will take all following nodes added to the page. */
 void SVGTree::pushPageContext (unique_ptr<XMLElement> node) {
 	XMLElement *nodePtr = node.get();
+	flushPage();
 	if (_pageContextStack.empty())
 		_page->append(std::move(node));
 	else
@@ -333,6 +348,45 @@ void SVGTree::popPageContext () {
 }
 
 
+/** Replaces the completed child nodes of the page element by their serialized
+ *  form. This way, the subtrees of large pages needn't be kept in memory until
+ *  the page is written. All children except the last one are considered
+ *  completed if no page context is active because the character handlers
+ *  only extend the last child. Serialization stops at the first element
+ *  referencing a clip path since the optimizer might remove the clipPath
+ *  elements that are no longer referenced by the page tree. */
+void SVGTree::flushPage () {
+	if (!STREAM_PAGES || _flushBlocked || !_page || !_pageContextStack.empty())
+		return;
+	XMLMarkup *markup = _flushMark ? _flushMark->toMarkup() : nullptr;
+	XMLNode *node = _flushMark ? _flushMark->next() : _page->firstChild();
+	while (node && node != _page->lastChild()) {
+		XMLNode *next = node->next();
+		if (node->toText() || node->toMarkup()) {
+			// text nodes are kept to get the same line breaks as without flushing
+			_flushMark = node;
+			markup = nullptr;
+		}
+		else {
+			if (XMLElement *elem = node->toElement()) {
+				vector<XMLElement*> clipped;
+				if (elem->hasAttribute("clip-path") || elem->getDescendants(nullptr, "clip-path", clipped)) {
+					_flushBlocked = true;
+					break;
+				}
+			}
+			if (!markup) {
+				markup = static_cast<XMLMarkup*>(_page->insertBefore(util::make_unique<XMLMarkup>(), node));
+				_flushMark = markup;
+			}
+			markup->append(*node);
+			XMLElement::detach(node);
+		}
+		node = next;
+	}
+}
+
+
 XMLCData* SVGTree::styleCDataNode () {
 	if (!_styleCDataNode) {
 		auto styleNode = util::make_unique<XMLElement>("style");
@@ -61,6 +61,7 @@ class SVGTree {
 		void setBBox (const BoundingBox &bbox);
 		void setFont (int id, const Font &font);
 		static bool setFontFormat (std::string formatstr);
+		void setFontFileDir (const std::string &dir) {_fontFileDir = dir;}
 		void setX (double x)              {_charHandler->notifyXAdjusted();}
 		void setY (double y)              {_charHandler->notifyYAdjusted();}
 		void setMatrix (const Matrix &m)  {_charHandler->setMatrix(m);}
@@ -75,21 +76,27 @@ class SVGTree {
 
 	protected:
 		XMLCData* styleCDataNode ();
+		void flushPage ();
 
 	public:
 		static bool USE_FONTS;           ///< if true, create font references and don't draw paths directly
 		static bool CREATE_CSS;          ///< define and use CSS classes to reference fonts?
 		static bool CREATE_USE_ELEMENTS; ///< allow generation of <use/> elements?
 		static FontWriter::FontFormat FONT_FORMAT;   ///< format of fonts to be embedded
+		static bool LINK_FONTS;          ///< reference separate font files rather than embedding the font data?
 		static bool RELATIVE_PATH_CMDS;  ///< relative path commands rather than absolute ones?
 		static bool MERGE_CHARS;         ///< whether to merge chars with common properties into the same <text> tag
 		static bool ADD_COMMENTS;        ///< add comments with additional information
 		static double ZOOM_FACTOR;       ///< factor applied to width/height attribute
+		static bool STREAM_PAGES;        ///< serialize completed page elements right away?
 
 	private:
 		XMLDocument _doc;
 		XMLElement *_root, *_page, *_defs;
 		XMLCData *_styleCDataNode;
+		XMLNode *_flushMark;             ///< last page child already processed by flushPage()
+		bool _flushBlocked;              ///< true if the remaining page elements must be kept
+		std::string _fontFileDir;        ///< directory where linked font files are stored
 		std::unique_ptr<SVGCharHandler> _charHandler;
 		std::stack<XMLElement*> _defsContextStack;
 		std::stack<XMLElement*> _pageContextStack;
@@ -50,6 +50,9 @@ class SpecialHandler {
 		virtual void dviBeginPage (unsigned pageno, SpecialActions &actions) {}
 		virtual void dviEndPage (unsigned pageno, SpecialActions &actions) {}
 		virtual void dviMovedTo (double x, double y, SpecialActions &actions) {}
+		/** Returns true if the specials seen during preprocessing can pass state from one
+		 *  page to the next that can't be restored if pages are converted out of order. */
+		virtual bool carriesPageState () const {return false;}
 };
 
 #endif
@@ -163,6 +163,16 @@ void SpecialManager::notifyPositionChange (double x, double y, SpecialActions &a
 }
 
 
+/** Returns true if any of the registered handlers can pass state from one page to
+ *  the next that depends on the order in which the pages are converted. */
+bool SpecialManager::carriesPageState () const {
+	for (auto &handler : _handlerPool)
+		if (handler->carriesPageState())
+			return true;
+	return false;
+}
+
+
 void SpecialManager::writeHandlerInfo (ostream &os) const {
 	ios::fmtflags osflags(os.flags());
 	map<string,SpecialHandler*> sortmap;
@@ -47,6 +47,7 @@ class SpecialManager {
 		void notifyBeginPage (unsigned pageno, SpecialActions &actions) const;
 		void notifyEndPage (unsigned pageno, SpecialActions &actions) const;
 		void notifyPositionChange (double x, double y, SpecialActions &actions) const;
+		bool carriesPageState () const;
 		void writeHandlerInfo (std::ostream &os) const;
 		SpecialHandler* findHandlerByName (const std::string &name) const;
 
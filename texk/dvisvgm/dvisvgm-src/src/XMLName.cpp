@@ -0,0 +1,43 @@
+/*************************************************************************
+** XMLName.cpp                                                          **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <unordered_set>
+#include "XMLName.hpp"
+
+using namespace std;
+
+/** Returns the table of all names created so far. */
+static unordered_set<string>& name_table () {
+	static unordered_set<string> names;
+	return names;
+}
+
+
+XMLName::XMLName (const char *name) : XMLName(string(name)) {
+}
+
+
+XMLName::XMLName (const string &name) {
+	auto &names = name_table();
+	auto it = names.find(name);
+	if (it == names.end())
+		it = names.insert(name).first;
+	_name = &(*it);
+}
@@ -0,0 +1,61 @@
+/*************************************************************************
+** XMLName.hpp                                                          **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef XMLNAME_HPP
+#define XMLNAME_HPP
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+/** Name of an XML element or attribute. The name strings are kept in a global
+ *  table so that each distinct name is stored only once, and two XMLName objects
+ *  can be compared by the addresses of their strings. */
+class XMLName {
+	public:
+		XMLName (const char *name);
+		XMLName (const std::string &name);
+		const std::string& str () const {return *_name;}
+		const char* c_str () const      {return _name->c_str();}
+		operator const std::string& () const {return *_name;}
+		bool operator == (const XMLName &name) const {return _name == name._name;}
+		bool operator != (const XMLName &name) const {return _name != name._name;}
+		bool operator == (const std::string &name) const {return *_name == name;}
+		bool operator != (const std::string &name) const {return *_name != name;}
+		bool operator == (const char *name) const {return *_name == name;}
+		bool operator != (const char *name) const {return *_name != name;}
+		size_t hash () const {return std::hash<const std::string*>()(_name);}
+
+	private:
+		const std::string *_name;
+};
+
+
+inline bool operator == (const std::string &str, const XMLName &name) {return name == str;}
+inline bool operator != (const std::string &str, const XMLName &name) {return name != str;}
+inline std::ostream& operator << (std::ostream &os, const XMLName &name) {return os << name.str();}
+
+namespace std {
+	template<> struct hash<XMLName> {
+		size_t operator () (const XMLName &name) const {return name.hash();}
+	};
+}
+
+#endif
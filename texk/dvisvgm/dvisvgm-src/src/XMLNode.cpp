@@ -65,7 +65,7 @@ unique_ptr<XMLNode> XMLNode::removeNext () {
 
 /////////////////////////////////////////////////////////////////////
 
-XMLElement::XMLElement (string name) : _name(std::move(name)) {
+XMLElement::XMLElement (const XMLName &name) : _name(name) {
 }
 
 
@@ -79,7 +79,7 @@ XMLElement::XMLElement (const XMLElement &node)
 
 XMLElement::XMLElement (XMLElement &&node) noexcept
 	: XMLNode(std::move(node)),
-	_name(std::move(node._name)),
+	_name(node._name),
 	_attributes(std::move(node._attributes)),
 	_firstChild(std::move(node._firstChild)),
 	_lastChild(node._lastChild)
@@ -103,23 +103,22 @@ void XMLElement::clear () {
 }
 
 
-void XMLElement::addAttribute (const string &name, const string &value) {
+void XMLElement::addAttribute (const XMLName &name, string value) {
 	if (Attribute *attr = getAttribute(name))
-		attr->value = value;
+		attr->value = std::move(value);
 	else
-		_attributes.emplace_back(Attribute(name, value));
+		_attributes.emplace_back(name, std::move(value));
 }
 
 
-void XMLElement::addAttribute (const string &name, double value) {
+void XMLElement::addAttribute (const XMLName &name, double value) {
 	addAttribute(name, XMLString(value));
 }
 
 
-void XMLElement::removeAttribute (const std::string &name) {
-	_attributes.erase(find_if(_attributes.begin(), _attributes.end(), [&](const Attribute &attr) {
-		return attr.name == name;
-	}));
+void XMLElement::removeAttribute (const string &name) {
+	if (Attribute *attr = getAttribute(name))
+		_attributes.erase(_attributes.begin() + (attr - _attributes.data()));
 }
 
 
@@ -359,10 +358,11 @@ ostream& XMLElement::write (ostream &os) const {
 	os << '<' << _name;
 	for (const auto &attrib : _attributes) {
 		os << ' ';
-		if (attrib.name.front() != '@')
-			os << attrib.name << "='" << attrib.value << '\'';
+		const string &name = attrib.name;
+		if (name.front() != '@')
+			os << name << "='" << attrib.value << '\'';
 		else {
-			os << attrib.name.substr(1) << "='";
+			os << name.substr(1) << "='";
 			size_t pos = attrib.value.find("base64,");
 			if (pos == string::npos)
 				os << attrib.value;
@@ -411,7 +411,7 @@ bool XMLElement::hasAttribute (const string &name) const {
 /** Returns the value of an attribute.
  *  @param[in] name name of attribute
  *  @return attribute value or 0 if attribute doesn't exist */
-const char* XMLElement::getAttributeValue (const std::string& name) const {
+const char* XMLElement::getAttributeValue (const string &name) const {
 	if (const Attribute *attr = getAttribute(name))
 		return attr->value.c_str();
 	return nullptr;
@@ -419,16 +419,18 @@ const char* XMLElement::getAttributeValue (const std::string& name) const {
 
 
 XMLElement::Attribute* XMLElement::getAttribute (const string &name) {
-	auto it = find_if(_attributes.begin(), _attributes.end(), [&](const Attribute &attr) {
-		return attr.name == name;
-	});
-	return it != _attributes.end() ? &(*it) : nullptr;
+	return const_cast<Attribute*>(static_cast<const XMLElement*>(this)->getAttribute(name));
 }
 
 
+/** Returns the attribute of a given name or nullptr if there is none. The lookup
+ *  compares the strings instead of creating an XMLName, so that names that are
+ *  only looked up don't end up in the name table. An XMLName passed as argument
+ *  refers to the interned string and is found by its address.
+ *  @param[in] name name of attribute */
 const XMLElement::Attribute* XMLElement::getAttribute (const string &name) const {
 	auto it = find_if(_attributes.begin(), _attributes.end(), [&](const Attribute &attr) {
-		return attr.name == name;
+		return &attr.name.str() == &name || attr.name.str() == name;
 	});
 	return it != _attributes.end() ? &(*it) : nullptr;
 }
@@ -486,3 +488,17 @@ void XMLCData::append (string &&str) {
 	else
 		_data += str;
 }
+
+/////////////////////////////////////////////////////////////////////
+
+/** Appends the serialized form of a node. Only non-text nodes must be appended
+ *  so that the separating newlines are the same as in the serialized parent element.
+ *  @param[in] node node to be serialized */
+void XMLMarkup::append (const XMLNode &node) {
+	ostringstream oss;
+	if (_numNodes > 0 && XMLElement::WRITE_NEWLINES)
+		oss << '\n';
+	node.write(oss);
+	_markup += oss.str();
+	_numNodes++;
+}
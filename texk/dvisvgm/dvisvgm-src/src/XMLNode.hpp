@@ -28,10 +28,12 @@
 #include <string>
 #include <vector>
 #include "utility.hpp"
+#include "XMLName.hpp"
 
 class XMLCData;
 class XMLComment;
 class XMLElement;
+class XMLMarkup;
 class XMLText;
 
 class XMLNode {
@@ -55,10 +57,12 @@ class XMLNode {
 		virtual const XMLText* toWSNode () const     {return nullptr;}
 		virtual const XMLComment* toComment () const {return nullptr;}
 		virtual const XMLCData* toCData () const     {return nullptr;}
+		virtual const XMLMarkup* toMarkup () const   {return nullptr;}
 		XMLElement* toElement ()  {return cast<XMLElement>(&XMLNode::toElement);}
 		XMLText* toText ()        {return cast<XMLText>(&XMLNode::toText);}
 		XMLComment* toComment ()  {return cast<XMLComment>(&XMLNode::toComment);}
 		XMLCData* toCData ()      {return cast<XMLCData>(&XMLNode::toCData);}
+		XMLMarkup* toMarkup ()    {return cast<XMLMarkup>(&XMLNode::toMarkup);}
 		XMLNode* parent () const  {return _parent;}
 		XMLNode* prev () const    {return _prev;}
 		XMLNode* next () const    {return _next.get();}
@@ -117,22 +121,22 @@ class ConstXMLNodeIterator {
 class XMLElement : public XMLNode {
 	public:
 		struct Attribute {
-			Attribute (std::string nam, std::string val) : name(std::move(nam)), value(std::move(val)) {}
-			std::string name;
+			Attribute (const XMLName &nam, std::string val) : name(nam), value(std::move(val)) {}
+			XMLName name;
 			std::string value;
 		};
 		using Attributes = std::vector<Attribute>;
 		static bool WRITE_NEWLINES;  ///< insert line breaks after element tags?
 
 	public:
-		explicit XMLElement (std::string name);
+		explicit XMLElement (const XMLName &name);
 		XMLElement (const XMLElement &node);
 		XMLElement (XMLElement &&node) noexcept;
 		~XMLElement ();
 		std::unique_ptr<XMLNode> clone () const override {return util::make_unique<XMLElement>(*this);}
 		void clear () override;
-		void addAttribute (const std::string &name, const std::string &value);
-		void addAttribute (const std::string &name, double value);
+		void addAttribute (const XMLName &name, std::string value);
+		void addAttribute (const XMLName &name, double value);
 		void removeAttribute (const std::string &name);
 		XMLNode* append (std::unique_ptr<XMLNode> child);
 		XMLNode* append (const std::string &str);
@@ -153,7 +157,7 @@ class XMLElement : public XMLNode {
 		XMLNodeIterator end () {return XMLNodeIterator(nullptr);}
 		ConstXMLNodeIterator begin () const {return ConstXMLNodeIterator(_firstChild.get());}
 		ConstXMLNodeIterator end () const {return ConstXMLNodeIterator(nullptr);}
-		const std::string& name () const {return _name;}
+		const XMLName& name () const {return _name;}
 		const XMLElement* toElement () const override {return this;}
 		const Attribute* getAttribute (const std::string &name) const;
 
@@ -167,7 +171,7 @@ class XMLElement : public XMLNode {
 		XMLNode* insertLast (std::unique_ptr<XMLNode> child);
 
 	private:
-		std::string _name;     // element name (<name a1="v1" .. an="vn">...</name>)
+		XMLName _name;         // element name (<name a1="v1" .. an="vn">...</name>)
 		std::vector<Attribute> _attributes;
 		std::unique_ptr<XMLNode> _firstChild;  ///< pointer to first child node (incl. ownership)
 		XMLNode *_lastChild=nullptr;  ///< pointer to last child node
@@ -221,6 +225,24 @@ class XMLCData : public XMLNode {
 };
 
 
+/** Sequence of sibling nodes that have already been serialized. It's used to drop
+ *  the subtrees of completed nodes while the remaining tree is still being built. */
+class XMLMarkup : public XMLNode {
+	public:
+		XMLMarkup () =default;
+		std::unique_ptr<XMLNode> clone () const override {return util::make_unique<XMLMarkup>(*this);}
+		void clear () override {_markup.clear(); _numNodes=0;}
+		void append (const XMLNode &node);
+		std::ostream& write (std::ostream &os) const override {return os << _markup;}
+		const XMLMarkup* toMarkup () const override {return this;}
+		size_t numNodes () const {return _numNodes;}
+
+	private:
+		std::string _markup;
+		size_t _numNodes=0;  ///< number of serialized nodes
+};
+
+
 inline std::ostream& operator << (std::ostream &os, const XMLElement &node) {return node.write(os);}
 inline std::ostream& operator << (std::ostream &os, const XMLText &node) {return node.write(os);}
 inline std::ostream& operator << (std::ostream &os, const XMLComment &node) {return node.write(os);}
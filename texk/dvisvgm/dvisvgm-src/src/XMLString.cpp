@@ -82,6 +82,47 @@ static inline double round (double x, int n) {
 }
 
 
+/** Returns the decimal representation of a floating point value with at most 6
+ *  decimal places and without trailing zeros. The result is identical to that of
+ *  util::to_string(double) but the printf-based conversion is only used in the
+ *  rare cases where rounding the value scaled by 10^6 could be ambiguous.
+ *  @param[in] x number to convert
+ *  @return string representation of x */
+static string to_string (double x) {
+	double scaled = std::abs(x)*1e6;
+	double intpart;
+	double frac = modf(scaled, &intpart);
+	// The error of the scaled value is below 0.0002 for |x| < 10^6, so we can round
+	// it safely as long as its fractional part isn't close to 0.5.
+	if (!std::isfinite(x) || scaled >= 1e12 || std::abs(frac-0.5) < 1e-3)
+		return util::to_string(x);
+	auto n = static_cast<unsigned long long>(intpart) + (frac > 0.5 ? 1 : 0);
+	char buf[32];
+	char *p = buf+sizeof(buf);
+	auto fracdigits = unsigned(n%1000000);
+	n /= 1000000;
+	if (fracdigits > 0) {
+		int numdigits = 6;
+		while (fracdigits%10 == 0) {  // skip trailing zeros
+			fracdigits /= 10;
+			numdigits--;
+		}
+		for (int i=0; i < numdigits; i++) {
+			*--p = char('0'+fracdigits%10);
+			fracdigits /= 10;
+		}
+		*--p = '.';
+	}
+	do {
+		*--p = char('0'+n%10);
+		n /= 10;
+	} while (n > 0);
+	if (x < 0)
+		*--p = '-';
+	return string(p, buf+sizeof(buf)-p);
+}
+
+
 XMLString::XMLString (double x) {
 	if (DECIMAL_PLACES > 0) {
 		// don't use fixed and setprecision() manipulators here to avoid
@@ -90,7 +131,7 @@ XMLString::XMLString (double x) {
 	}
 	if (std::abs(x) < 1e-6)
 		x = 0;
-	assign(util::to_string(x));
+	assign(::to_string(x));
 	size_t pos = find("0.");
 	if (pos != string::npos && (pos == 0 || at(pos-1) == '-'))
 		erase(pos, 1);
@@ -358,6 +358,9 @@ static void set_variables (const CommandLine &cmdline) {
 	SVGTree::MERGE_CHARS = !cmdline.noMergeOpt.given();
 	SVGTree::ADD_COMMENTS = cmdline.commentsOpt.given();
 	DVIToSVG::TRACE_MODE = cmdline.traceAllOpt.given() ? (cmdline.traceAllOpt.value() ? 'a' : 'm') : 0;
+#ifndef _WIN32
+	DVIToSVG::PARALLEL_JOBS = cmdline.stdoutOpt.given() ? 1 : max(1u, cmdline.jobsOpt.value());
+#endif
 	Message::LEVEL = cmdline.verbosityOpt.value();
 	PhysicalFont::EXACT_BBOX = cmdline.exactBboxOpt.given();
 	PhysicalFont::KEEP_TEMP_FILES = cmdline.keepOpt.given();
@@ -369,6 +372,7 @@ static void set_variables (const CommandLine &cmdline) {
 	PsSpecialHandler::SHADING_SEGMENT_SIZE = max(1, cmdline.gradSegmentsOpt.value());
 	PsSpecialHandler::SHADING_SIMPLIFY_DELTA = cmdline.gradSimplifyOpt.value();
 	PsSpecialHandler::BITMAP_FORMAT = util::tolower(cmdline.bitmapFormatOpt.value());
+	PsSpecialHandler::REPLAY_LITERALS = cmdline.replayPsOpt.given();
 	if (!PSInterpreter::imageDeviceKnown(PsSpecialHandler::BITMAP_FORMAT)) {
 		ostringstream oss;
 		oss << "unknown image format '" << PsSpecialHandler::BITMAP_FORMAT << "'\nknown formats:\n";
@@ -388,6 +392,9 @@ static void set_variables (const CommandLine &cmdline) {
 			throw CL::CommandLineException(msg);
 		}
 	}
+	// all optimizer modules except remove-clippath require the complete page tree
+	const string &modseq = SVGOptimizer::MODULE_SEQUENCE;
+	SVGTree::STREAM_PAGES = (modseq.empty() || modseq == "none" || modseq == "remove-clippath");
 }
 
 
@@ -473,6 +480,7 @@ int main (int argc, char *argv[]) {
 			dvi2svg.setProcessSpecials(ignore_specials, true);
 			dvi2svg.setPageTransformation(get_transformation_string(cmdline));
 			dvi2svg.setPageSize(cmdline.bboxOpt.value());
+			dvi2svg.setInputFilePath(srcin.getFilePath());
 
 			dvi2svg.convert(cmdline.pageOpt.value(), &pageinfo);
 			timer_message(start_time, &pageinfo);
@@ -20,8 +20,7 @@
 
 #pragma once
 
-#include <set>
-#include <string>
+#include <unordered_set>
 #include "OptimizerModule.hpp"
 #include "../XMLNode.hpp"
 
@@ -55,7 +54,7 @@ class AttributeExtractor : public OptimizerModule {
 		bool extracted (const Attribute &attr) const;
 
 	private:
-		std::set<std::string> _extractedAttributes;
+		std::unordered_set<XMLName> _extractedAttributes;
 		static constexpr int MIN_RUN_LENGTH = 3;
 };
 
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <array>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "AttributeExtractor.hpp"
 #include "GroupCollapser.hpp"
@@ -106,7 +107,7 @@ void GroupCollapser::execute (XMLElement *context) {
  *  @param[in] dest element that receives the attributes
  *  @return true if all attributes have been moved */
 bool GroupCollapser::moveAttributes (XMLElement &source, XMLElement &dest) {
-	vector<string> movedAttributes;
+	vector<XMLName> movedAttributes;
 	for (const XMLElement::Attribute &attr : source.attributes()) {
 		if (attr.name == "transform") {
 			string transform;
@@ -122,7 +123,7 @@ bool GroupCollapser::moveAttributes (XMLElement &source, XMLElement &dest) {
 			movedAttributes.emplace_back(attr.name);
 		}
 	}
-	for (const string &attrname : movedAttributes)
+	for (const XMLName &attrname : movedAttributes)
 		source.removeAttribute(attrname);
 	return source.attributes().empty();
 }
@@ -134,13 +135,10 @@ bool GroupCollapser::moveAttributes (XMLElement &source, XMLElement &dest) {
 bool GroupCollapser::collapsible (const XMLElement &element) {
 	// the 'fill' attribute of animation elements has different semantics than
 	// that of graphics elements => don't collapse them
-	static const char *names[] = {
+	static const unordered_set<XMLName> names = {
 		"animate", "animateColor", "animateMotion", "animateTransform", "set"
 	};
-	auto it = find_if(begin(names), end(names), [&](const string &name) {
-		return element.name() == name;
-	});
-	return it == end(names);
+	return names.find(element.name()) == names.end();
 }
 
 
@@ -160,10 +158,10 @@ bool GroupCollapser::unwrappable (const XMLElement &source, const XMLElement &de
 			return false;
 	}
 	// these attributes prevent a group from being unwrapped
-	static const char *attribs[] = {
+	static const XMLName attribs[] = {
 		"class", "id", "filter", "mask", "style"
 	};
-	auto it = find_if(begin(attribs), end(attribs), [&](const string &name) {
+	auto it = find_if(begin(attribs), end(attribs), [&](const XMLName &name) {
 		return source.hasAttribute(name) || dest.hasAttribute(name);
 	});
 	return it == end(attribs);
@@ -29,11 +29,16 @@ class ColorSpecialTest : public ::testing::Test {
 	protected:
 		struct SetColor : EmptySpecialActions {
 			SetColor () : color(0) {}
-			void setColor (const Color &c) {color = uint32_t(c);}
+			void setColor (const Color &c) override {color = uint32_t(c);}
+			unsigned getCurrentPageNumber () const override {return pageno;}
 			bool equals (uint32_t c) {return color == c;}
 			uint32_t color;
+			unsigned pageno=0;
 		};
-		ColorSpecialHandler handler;
+		struct MyColorSpecialHandler : ColorSpecialHandler {
+			void beginPage (unsigned pageno, SpecialActions &actions) {dviBeginPage(pageno, actions);}
+		};
+		MyColorSpecialHandler handler;
 		SetColor actions;
 };
 
@@ -145,3 +150,26 @@ TEST_F(ColorSpecialTest, errors) {
 	EXPECT_THROW(handler.process("", iss, actions), SpecialException);
 }
 
+
+TEST_F(ColorSpecialTest, restoreStack) {
+	// page 1 pushes red, page 3 pushes blue, page 5 pops both
+	const char *specials[][2] = {{"1", "push rgb 1 0 0"}, {"3", "push rgb 0 0 1"}, {"5", "pop"}, {"5", "pop"}};
+	for (auto &special : specials) {
+		std::istringstream iss(special[1]);
+		actions.pageno = unsigned(stoi(special[0]));
+		handler.preprocess("", iss, actions);
+	}
+	// convert the pages out of order; the color is only set if the stack changes
+	const uint32_t colors[] = {0x000000, 0xff0000, 0xff0000, 0x0000ff, 0x0000ff, 0x000000};
+	uint32_t expected = 0x000000;
+	for (unsigned pageno : {4, 5, 2, 6, 1, 3}) {
+		actions.color = 0x123456;
+		handler.beginPage(pageno, actions);
+		if (colors[pageno-1] == expected)
+			EXPECT_TRUE(actions.equals(0x123456)) << "page " << pageno;
+		else {
+			expected = colors[pageno-1];
+			EXPECT_TRUE(actions.equals(expected)) << "page " << pageno;
+		}
+	}
+}
@@ -137,6 +137,23 @@ TEST_F(FontCacheTest, read) {
 }
 
 
+TEST_F(FontCacheTest, write_unchanged) {
+	cache.setGlyph(1, glyph1);
+	ASSERT_TRUE(cache.write("testfont", cachedir));
+	cache.clear();
+	ASSERT_TRUE(cache.read("testfont", cachedir));
+	cache.setGlyph(10, glyph2);
+	ASSERT_TRUE(cache.write(cachedir));
+	// unchanged data must not be written again
+	ASSERT_TRUE(FileSystem::remove(cachedir+"/testfont.fgd"));
+	EXPECT_TRUE(cache.write(cachedir));
+	EXPECT_FALSE(FileSystem::exists(cachedir+"/testfont.fgd"));
+	cache.setGlyph(20, glyph1);
+	EXPECT_TRUE(cache.write(cachedir));
+	EXPECT_TRUE(FileSystem::exists(cachedir+"/testfont.fgd"));
+}
+
+
 TEST_F(FontCacheTest, fontinfo1) {
 	ostringstream oss;
 	cache.clear();
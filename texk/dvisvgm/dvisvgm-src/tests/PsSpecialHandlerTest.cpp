@@ -0,0 +1,62 @@
+/*************************************************************************
+** PsSpecialHandlerTest.cpp                                             **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include "PsSpecialHandler.hpp"
+
+using namespace std;
+
+
+TEST(PsSpecialHandlerTest, selfContained) {
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained(""));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("0 0 moveto 10 10 lineto stroke"));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("newpath 0 0 5 0 360 arc 0.5 setgray fill"));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("gsave 1 0 0 setrgbcolor -.5 1e-2 16#FF 2#101 rlineto grestore"));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("/a 3 def 4 {0 0 moveto} repeat"));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("[1 2] 0 setdash << /k (v) >> pop (a (nested\\) string)) pop <414243> pop"));
+	EXPECT_TRUE(PsSpecialHandler::isSelfContained("% comment with fill and tx@Dict\n0 0 moveto"));
+}
+
+
+TEST(PsSpecialHandlerTest, notSelfContained) {
+	// names that may be defined by headers or other specials
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("tx@Dict begin STP newpath end"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("/p {0 0 moveto} def p"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("{0 0 moveto foo} exec"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("//fill exec"));
+	// access to dictionaries, VM, fonts, and other state not tracked by the handler
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("true setglobal"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("globaldict /x 1 put"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("userdict /x get"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("/x load"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("(x) cvx exec"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("/Times-Roman findfont 10 scalefont setfont (x) show"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("0 0 10 10 rectclip"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("rand pop"));
+	// names that look like numbers to strtod
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("nan inf"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("0x10 pop"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("e5 pop"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("2#102 pop"));
+	// syntax errors
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("(unterminated"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("<4142"));
+	EXPECT_FALSE(PsSpecialHandler::isSelfContained("1 ) pop"));
+}
@@ -0,0 +1,141 @@
+/*************************************************************************
+** SVGTreeBenchmark.cpp                                                 **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+// Compares the peak heap usage and the throughput of building and writing large
+// SVG pages with and without serializing the completed page elements right away
+// (see SVGTree::STREAM_PAGES). It's not part of the test suite and must be run
+// manually, e.g.: make SVGTreeBenchmark && ./SVGTreeBenchmark 200
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include "SVGTree.hpp"
+#include "utility.hpp"
+#include "XMLNode.hpp"
+#include "XMLString.hpp"
+
+using namespace std;
+
+static size_t heap_size=0;  // number of bytes currently allocated by operator new
+static size_t heap_peak=0;  // maximum of heap_size since last reset
+static constexpr size_t HEADER_SIZE = sizeof(max_align_t);
+
+void* operator new (size_t size) {
+	void *ptr = malloc(size+HEADER_SIZE);
+	if (!ptr)
+		throw bad_alloc();
+	*static_cast<size_t*>(ptr) = size;
+	heap_size += size;
+	heap_peak = max(heap_peak, heap_size);
+	return static_cast<char*>(ptr)+HEADER_SIZE;
+}
+
+
+void operator delete (void *ptr) noexcept {
+	if (ptr) {
+		ptr = static_cast<char*>(ptr)-HEADER_SIZE;
+		heap_size -= *static_cast<size_t*>(ptr);
+		free(ptr);
+	}
+}
+
+
+void operator delete (void *ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+
+
+/** Stream buffer that discards all characters but counts them. */
+class CountingBuffer : public streambuf {
+	public:
+		size_t count () const {return _count;}
+
+	protected:
+		int_type overflow (int_type c) override {_count++; return c;}
+		streamsize xsputn (const char*, streamsize n) override {_count += n; return n;}
+
+	private:
+		size_t _count=0;
+};
+
+
+/** Adds elements to the current page that resemble those created for a
+ *  dense page of text with some rules. */
+static void build_page (SVGTree &svg, int lines) {
+	static const char *words[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog"};
+	for (int i=0; i < lines; i++) {
+		auto text = util::make_unique<XMLElement>("text");
+		text->addAttribute("class", "f0");
+		text->addAttribute("x", 72.0);
+		text->addAttribute("y", 72.0+12.0*i);
+		for (int j=0; j < 10; j++) {
+			auto tspan = util::make_unique<XMLElement>("tspan");
+			tspan->addAttribute("x", 72.0+27.1828*j);
+			tspan->append(XMLString(words[(i+j)%8]));
+			text->append(std::move(tspan));
+		}
+		svg.appendToPage(std::move(text));
+		if (i%4 == 0) {
+			auto rect = util::make_unique<XMLElement>("rect");
+			rect->addAttribute("x", 72.0);
+			rect->addAttribute("y", 72.0+12.0*i);
+			rect->addAttribute("height", 0.4);
+			rect->addAttribute("width", 300.0);
+			svg.appendToPage(std::move(rect));
+		}
+	}
+}
+
+
+static void run (bool stream, int pages, int lines) {
+	SVGTree::STREAM_PAGES = stream;
+	SVGTree svg;
+	CountingBuffer buf;
+	ostream os(&buf);
+	heap_peak = heap_size;
+	size_t heap_base = heap_size;
+	auto start = chrono::steady_clock::now();
+	for (int i=1; i <= pages; i++) {
+		svg.newPage(i);
+		build_page(svg, lines);
+		svg.write(os);
+		svg.reset();
+	}
+	chrono::duration<double> secs = chrono::steady_clock::now()-start;
+	cout << setw(6) << (stream ? "stream" : "DOM")
+		<< fixed << setprecision(2)
+		<< setw(10) << (heap_peak-heap_base)/1e6 << " MB peak heap"
+		<< setw(10) << buf.count()/secs.count()/1e6 << " MB/s"
+		<< setw(10) << pages/secs.count() << " pages/s\n";
+}
+
+
+int main (int argc, char *argv[]) {
+	int pages = argc > 1 ? max(1, atoi(argv[1])) : 100;
+	int lines = argc > 2 ? max(1, atoi(argv[2])) : 2000;
+	cout << pages << " pages of " << lines << " lines\n";
+	run(false, pages, lines);
+	run(true, pages, lines);
+	return 0;
+}
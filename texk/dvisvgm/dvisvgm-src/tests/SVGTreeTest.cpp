@@ -0,0 +1,114 @@
+/*************************************************************************
+** SVGTreeTest.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <sstream>
+#include "SVGTree.hpp"
+#include "utility.hpp"
+#include "XMLNode.hpp"
+
+using namespace std;
+
+class SVGTreeTest : public ::testing::Test {
+	protected:
+		void TearDown () override {
+			SVGTree::STREAM_PAGES = false;
+		}
+
+		static unique_ptr<XMLElement> rect (int x) {
+			auto elem = util::make_unique<XMLElement>("rect");
+			elem->addAttribute("x", x);
+			elem->addAttribute("width", 5);
+			return elem;
+		}
+
+		/** Builds a page with the given function and returns the serialized SVG document.
+		 *  @param[in] stream if true, completed page elements are serialized while building the page
+		 *  @param[in] build function adding the page content */
+		static string createPage (bool stream, const function<void(SVGTree&)> &build) {
+			SVGTree::STREAM_PAGES = stream;
+			SVGTree svg;
+			svg.newPage(1);
+			build(svg);
+			ostringstream oss;
+			svg.write(oss);
+			return oss.str();
+		}
+
+		static int countMarkupNodes (const XMLElement *elem) {
+			int count=0;
+			for (const XMLNode *node : *elem)
+				if (node->toMarkup())
+					count++;
+			return count;
+		}
+};
+
+
+TEST_F(SVGTreeTest, streamedPage) {
+	int markupNodes=0;
+	auto build = [&](SVGTree &svg) {
+		for (int i=0; i < 10; i++)
+			svg.appendToPage(rect(i));
+		svg.appendToPage(util::make_unique<XMLText>("text"));
+		svg.appendToPage(util::make_unique<XMLComment>("comment"));
+		svg.pushPageContext(util::make_unique<XMLElement>("g"));
+		svg.appendToPage(rect(20));
+		svg.appendToPage(rect(21));
+		svg.popPageContext();
+		svg.appendToDefs(util::make_unique<XMLElement>("path"));
+		svg.appendToPage(rect(30));
+		svg.prependToPage(rect(40));
+		svg.appendToPage(rect(50));
+		markupNodes = countMarkupNodes(svg.pageNode());
+	};
+	string domStr = createPage(false, build);
+	EXPECT_EQ(markupNodes, 0);
+	string streamStr = createPage(true, build);
+	EXPECT_EQ(markupNodes, 2);
+	EXPECT_EQ(streamStr, domStr);
+	EXPECT_NE(streamStr.find("<g id='page1'>\n<rect x='40' width='5'/>\n<rect x='0'"), string::npos);
+}
+
+
+TEST_F(SVGTreeTest, clipPath) {
+	int markupNodes=0;
+	vector<XMLElement*> clippedElements;
+	auto build = [&](SVGTree &svg) {
+		svg.appendToPage(rect(0));
+		svg.appendToPage(rect(1));
+		auto group = util::make_unique<XMLElement>("g");
+		group->addAttribute("clip-path", "url(#clip1)");
+		group->append(rect(2));
+		svg.appendToPage(std::move(group));
+		for (int i=3; i < 10; i++)
+			svg.appendToPage(rect(i));
+		markupNodes = countMarkupNodes(svg.pageNode());
+		clippedElements.clear();
+		svg.pageNode()->getDescendants(nullptr, "clip-path", clippedElements);
+	};
+	string domStr = createPage(false, build);
+	string streamStr = createPage(true, build);
+	EXPECT_EQ(streamStr, domStr);
+	// elements referencing a clip path and all following ones must be kept in the tree
+	EXPECT_EQ(markupNodes, 1);
+	EXPECT_EQ(clippedElements.size(), 1u);
+}
@@ -0,0 +1,54 @@
+/*************************************************************************
+** XMLNameTest.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2021 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include "XMLName.hpp"
+
+using namespace std;
+
+
+TEST(XMLNameTest, compare) {
+	XMLName name1("name");
+	XMLName name2(string("name"));
+	XMLName name3("other");
+	EXPECT_EQ(name1, name2);
+	EXPECT_EQ(&name1.str(), &name2.str());
+	EXPECT_NE(name1, name3);
+	EXPECT_NE(&name1.str(), &name3.str());
+	EXPECT_TRUE(name1 == "name");
+	EXPECT_TRUE(name1 != "other");
+	EXPECT_TRUE(name1 == string("name"));
+	EXPECT_TRUE(string("name") == name1);
+	EXPECT_TRUE(string("other") != name1);
+	EXPECT_EQ(name1.hash(), name2.hash());
+}
+
+
+TEST(XMLNameTest, str) {
+	XMLName name("attribute");
+	EXPECT_EQ(name.str(), "attribute");
+	EXPECT_STREQ(name.c_str(), "attribute");
+	const string &str = name;
+	EXPECT_EQ(str, "attribute");
+	ostringstream oss;
+	oss << name;
+	EXPECT_EQ(oss.str(), "attribute");
+}
@@ -213,6 +213,11 @@ TEST(XMLNodeTest, attributes) {
 	EXPECT_STREQ(root.getAttributeValue("integer"), "42");
 	EXPECT_STREQ(root.getAttributeValue("double"), "42.24");
 	EXPECT_EQ(root.getAttributeValue("none"), nullptr);
+	EXPECT_STREQ(root.getAttributeValue(string("string")), "text");
+	root.removeAttribute("none");
+	root.removeAttribute("integer");
+	EXPECT_FALSE(root.hasAttribute("integer"));
+	EXPECT_TRUE(root.hasAttribute("double"));
 }
 
 
@@ -391,3 +396,23 @@ TEST(XMLNodeTest, cdata) {
 	str.erase(remove(str.begin(), str.end(), '\n'), str.end());
 	EXPECT_EQ(str, "<root><element/><![CDATA[text & <text>]]></root>");
 }
+
+
+TEST(XMLNodeTest, markup) {
+	XMLElement root("root");
+	root.append(util::make_unique<XMLElement>("element1"));
+	auto markupNode = util::make_unique<XMLMarkup>();
+	auto elem = util::make_unique<XMLElement>("element2");
+	elem->addAttribute("attr", "value");
+	elem->append("text");
+	markupNode->append(*elem);
+	markupNode->append(XMLComment("comment"));
+	EXPECT_EQ(markupNode->numNodes(), 2u);
+	EXPECT_EQ(markupNode->toMarkup(), markupNode.get());
+	EXPECT_EQ(markupNode->toElement(), nullptr);
+	root.append(std::move(markupNode));
+	root.append(util::make_unique<XMLElement>("element3"));
+	ostringstream oss;
+	root.write(oss);
+	EXPECT_EQ(oss.str(), "<root>\n<element1/>\n<element2 attr='value'>text</element2>\n<!--comment-->\n<element3/>\n</root>");
+}
@@ -19,6 +19,8 @@
 *************************************************************************/
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include "utility.hpp"
 #include "XMLString.hpp"
 
 using namespace std;
@@ -65,4 +67,13 @@ TEST(XMLStringTest, doublecast) {
 
 	EXPECT_EQ(XMLString(10.0), string("10"));
 	EXPECT_EQ(XMLString(-10.0), string("-10"));
+	EXPECT_EQ(XMLString(0.5), string(".5"));
+	EXPECT_EQ(XMLString(-0.0000015), string("-.000002"));
+	EXPECT_EQ(XMLString(0.0000004), string("0"));
+	EXPECT_EQ(XMLString(123.4567894), string("123.456789"));
+	EXPECT_EQ(XMLString(99.9999996), string("100"));
+	EXPECT_EQ(XMLString(1e7+0.25), string("10000000.25"));
+	EXPECT_EQ(XMLString(1e12), string("1000000000000"));
+	EXPECT_EQ(XMLString(std::nan("")), util::to_string(std::nan("")));
+	EXPECT_EQ(XMLString(HUGE_VAL), util::to_string(HUGE_VAL));
 }
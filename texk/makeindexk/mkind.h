@@ -385,8 +385,15 @@ If any array overflows, please report to tex-k@tug.org.
 
 #define GERMAN 0
 
+#define FOLD_MAX 8	/* leading sort key bytes compared without */
+			/* touching the key string itself */
+
+/* the members used by every comparison in sort_idx() come first */
 typedef struct KFIELD
 {
+    unsigned char fold[FOLD_MAX];	/* case-folded head of sf[0] */
+    int     sgroup[FIELD_MAX];		/* group of each sort key */
+    int     agroup[FIELD_MAX];		/* group of each actual key */
     char    *sf[FIELD_MAX];		/* sort key */
     char    *af[FIELD_MAX];		/* actual key */
     int     group;			/* key group */
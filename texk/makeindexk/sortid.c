@@ -33,14 +33,16 @@
 #endif
 
 static	long	idx_gc;
+static	int	fold_keys;
 
 static int check_mixsym (const char *x, const char *y);
 static int compare (const void *va, const void *vb);
-static int compare_one (const char *x, const char *y);
+static int compare_one (const char *x, const char *y, int m, int n);
 static int compare_page (const FIELD_PTR *a, const FIELD_PTR *b);
 static int compare_string (const unsigned char *a, const unsigned char *b);
 static int new_strcmp (const unsigned char *a, const unsigned char *b,
            int option);
+static void prepare_key (FIELD_PTR key);
 
 void
 sort_idx(void)
@@ -48,6 +50,7 @@ sort_idx(void)
 #ifdef HAVE_SETLOCALE
     char *prev_locale;
 #endif
+    int     i;
 
     MESSAGE("Sorting entries...");
 #ifdef HAVE_SETLOCALE
@@ -56,6 +59,11 @@ sort_idx(void)
 #endif
     idx_dc = 0;
     idx_gc = 0L;
+    /* with plain case-insensitive ordering the first few letters of
+       the primary key decide most comparisons */
+    fold_keys = !locale_sort && !letter_ordering;
+    for (i = 0; i < idx_gt; i++)
+	prepare_key(idx_key[i]);
     qqsort(idx_key, (size_t)idx_gt, sizeof(FIELD_PTR), compare);
 #ifdef HAVE_SETLOCALE
     setlocale(LC_COLLATE, prev_locale);
@@ -74,13 +82,20 @@ compare(const void *va, const void *vb)
     idx_gc++;
     IDX_DOT(CMP_MAX);
 
+    /* two ALPHA keys whose folded heads differ are ordered by them */
+    if (fold_keys && (*a)->sgroup[0] == ALPHA && (*b)->sgroup[0] == ALPHA &&
+	(dif = memcmp((*a)->fold, (*b)->fold, FOLD_MAX)) != 0)
+	return (dif);
+
     for (i = 0; i < FIELD_MAX; i++) {
 	/* compare the sort fields */
-	if ((dif = compare_one((*a)->sf[i], (*b)->sf[i])) != 0)
+	if ((dif = compare_one((*a)->sf[i], (*b)->sf[i],
+			       (*a)->sgroup[i], (*b)->sgroup[i])) != 0)
 	    break;
 
 	/* compare the actual fields */
-	if ((dif = compare_one((*a)->af[i], (*b)->af[i])) != 0)
+	if ((dif = compare_one((*a)->af[i], (*b)->af[i],
+			       (*a)->agroup[i], (*b)->agroup[i])) != 0)
 	    break;
     }
 
@@ -90,12 +105,32 @@ compare(const void *va, const void *vb)
     return (dif);
 }
 
-static int
-compare_one(const char *x, const char *y)
+/*
+ * Compute once per entry what compare() would otherwise derive on every
+ * comparison: the group type of each key field and, for ALPHA keys, the
+ * case-folded head of the primary key padded with NULs.  Within the
+ * first FOLD_MAX bytes this orders exactly as compare_string() does.
+ */
+static void
+prepare_key(FIELD_PTR key)
 {
-    int     m;
-    int     n;
+    int     i;
+    const unsigned char *s = (const unsigned char *)key->sf[0];
 
+    for (i = 0; i < FIELD_MAX; i++) {
+	key->sgroup[i] = group_type(key->sf[i]);
+	key->agroup[i] = group_type(key->af[i]);
+    }
+    for (i = 0; i < FOLD_MAX && s[i] != NUL; i++)
+	key->fold[i] = TOLOWER(s[i]);
+    for (; i < FOLD_MAX; i++)
+	key->fold[i] = NUL;
+}
+
+/* m and n are the group types of x and y */
+static int
+compare_one(const char *x, const char *y, int m, int n)
+{
     if ((x[0] == NUL) && (y[0] == NUL))
 	return (0);
 
@@ -105,9 +140,6 @@ compare_one(const char *x, const char *y)
     if (y[0] == NUL)
 	return (1);
 
-    m = group_type(x);
-    n = group_type(y);
-
     /* both pure digits */
     if ((m >= 0) && (n >= 0))
 	return (m - n);
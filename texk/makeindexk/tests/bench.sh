@@ -0,0 +1,52 @@
+#! /bin/sh
+# this file is part of the makeindexk package
+# it times makeindex sorting a large generated .idx file
+# Compare the times before and after a change to the sort or merge code
+
+echo "This is bench.sh"
+echo "[MAKEINDEX_PATH=/the/path/to/makeindex ][MAKEINDEX_BENCH_ENTRIES=1000000 ][MAKEINDEX_BENCH_OPTIONS='-l' ]./bench.sh"
+
+if test -z "$MAKEINDEX_PATH"
+then
+MAKEINDEX_PATH="$(which makeindex)"
+fi
+if ! test -f "$MAKEINDEX_PATH" || ! test -x "$MAKEINDEX_PATH"
+then
+    echo "No executable file at $MAKEINDEX_PATH"
+    exit 1
+fi
+echo "makeindex command used: $MAKEINDEX_PATH"
+
+if test -z "$MAKEINDEX_BENCH_ENTRIES"
+then
+MAKEINDEX_BENCH_ENTRIES=1000000
+fi
+
+mkdir -p makeindex_bench
+cd makeindex_bench
+# random words so that the sort sees unordered input; a third of the
+# entries are subentries, some have an @ sort key, some repeat pages
+awk -v n=$MAKEINDEX_BENCH_ENTRIES 'BEGIN {
+  srand(1)
+  for (i = 0; i < n; i++) {
+    w = ""
+    for (j = 2 + int(rand() * 8); j > 0; j--)
+      w = w sprintf("%c", 97 + int(rand() * 26))
+    if (i % 3 == 0) {
+      s = ""
+      for (j = 2 + int(rand() * 8); j > 0; j--)
+        s = s sprintf("%c", 97 + int(rand() * 26))
+      w = w "!" s
+    } else if (i % 7 == 1)
+      w = toupper(substr(w, 1, 1)) substr(w, 2) "@\\emph{" w "}"
+    else if (i % 11 == 2)
+      w = int(rand() * 1000) "@" w
+    printf "\\indexentry{%s}{%d}\n", w, 1 + int(rand() * 2000)
+  }
+}' > bench.idx
+ls -l bench.idx
+
+rm -f bench.ind bench.ilg
+time "$MAKEINDEX_PATH" -q $MAKEINDEX_BENCH_OPTIONS bench.idx
+ls -l bench.ind
+cd ..
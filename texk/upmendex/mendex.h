@@ -25,6 +25,7 @@ struct index {
 	UChar *idx[3];
 	struct page *p;
 	int lnum;
+	int skey;
 };
 
 #define INITIALLENGTH 10
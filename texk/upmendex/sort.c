@@ -6,7 +6,31 @@
 
 int sym,nmbr,ltn,kana,hngl,hnz,cyr,grk;
 
+/*   collation keys, built once per entry before sorting   */
+struct sortseg {
+	int len;	/* length of the segment in UChars */
+	int order;	/* ordering() of its first character */
+	int kana;	/* is_jpn_kana() of its first character */
+	size_t key;	/* offset of its ICU sort key in keybuf */
+};
+
+struct sortkey {
+	int seg[3];	/* first segment of each level in segs */
+	int nseg[3];	/* number of segments of each level */
+	size_t idx[3];	/* offset of the sort key of idx[] in keybuf */
+};
+
+static struct sortkey *sortkeys;
+static struct sortseg *segs;
+static int nsegs, segsize;
+static uint8_t *keybuf;
+static size_t keylen, keysize;
+
+static void make_sortkeys(struct index *ind, int num);
+static void free_sortkeys(void);
+static size_t add_sortkey(const UChar *str, int len);
 static int wcomp(const void *p, const void *q);
+static int wcomp_strcoll(const void *p, const void *q);
 static int pcomp(const void *p, const void *q);
 static int ordering(UChar *c);
 static int get_charset_juncture(UChar *str);
@@ -101,11 +125,154 @@ BREAK:
 				    i, u_errorName(status));
 		}
 	}
+	make_sortkeys(ind,num);
 	qsort(ind,num,sizeof(struct index),wcomp);
+	free_sortkeys();
+}
+
+/*   convert every string wcomp_strcoll() would collate into an ICU sort key,
+     so that the comparisons while sorting are plain byte comparisons   */
+static void make_sortkeys(struct index *ind, int num)
+{
+	int i, j, k, len;
+	UChar *str;
+
+	sortkeys=xmalloc(sizeof(struct sortkey)*(num+1));
+	segsize=num*2+16;
+	segs=xmalloc(sizeof(struct sortseg)*segsize);
+	nsegs=0;
+	keysize=(size_t)num*64+1024;
+	keybuf=xmalloc(keysize);
+	keylen=0;
+
+	for (i=0;i<num;i++) {
+		ind[i].skey=i;
+		for (j=0;j<ind[i].words;j++) {
+			str=ind[i].dic[j];
+			sortkeys[i].seg[j]=nsegs;
+			for (k=0;str[k]!=L'\0';k+=len) {
+				if (nsegs==segsize) {
+					segsize*=2;
+					segs=xrealloc(segs,sizeof(struct sortseg)*segsize);
+				}
+				if (priority==0) len=u_strlen(&str[k]);
+				else len=get_charset_juncture(&str[k]);
+				segs[nsegs].len=len;
+				segs[nsegs].order=ordering(&str[k]);
+				segs[nsegs].kana=is_jpn_kana(&str[k]);
+				segs[nsegs].key=add_sortkey(&str[k],(priority==0) ? -1 : len);
+				nsegs++;
+				if (priority==0) break;
+			}
+			sortkeys[i].nseg[j]=nsegs-sortkeys[i].seg[j];
+			sortkeys[i].idx[j]=add_sortkey(ind[i].idx[j],-1);
+		}
+	}
+}
+
+static void free_sortkeys(void)
+{
+	free(sortkeys);
+	free(segs);
+	free(keybuf);
+	sortkeys=NULL;
+	segs=NULL;
+	keybuf=NULL;
+}
+
+/*   append the sort key of str to keybuf and return its offset   */
+static size_t add_sortkey(const UChar *str, int len)
+{
+	int32_t n;
+	size_t off=keylen;
+
+	for (;;) {
+		n=ucol_getSortKey(icu_collator, str, len, &keybuf[keylen], (int32_t)(keysize-keylen));
+		if (n==0) {
+			verb_printf(efp, "\n[ICU] Sort key creation failed.\n");
+			exit(254);
+		}
+		if ((size_t)n<=keysize-keylen) break;
+		keysize=keysize*2+n;
+		keybuf=xrealloc(keybuf,keysize);
+	}
+	keylen+=n;
+	return off;
 }
 
 /*   compare for sorting index   */
+/*   Sort keys compare (as byte strings) exactly as ucol_strcoll() does, so
+     this gives the same result as wcomp_strcoll(), which it falls back to
+     where the segments of the two entries stop lining up.   */
 static int wcomp(const void *p, const void *q)
+{
+	int j, s, cmp;
+	const struct index *index1 = p, *index2 = q;
+	const struct sortkey *key1, *key2;
+	const struct sortseg *seg1, *seg2;
+
+	scount++;
+
+	key1=&sortkeys[(*index1).skey];
+	key2=&sortkeys[(*index2).skey];
+	for (j=0;j<3;j++) {
+
+/*   check level   */
+		if (((*index1).words==j)&&((*index2).words!=j)) return -1;
+		else if (((*index1).words!=j)&&((*index2).words==j)) return 1;
+		else if ((*index1).words==j) return wcomp_strcoll(p,q);
+
+		seg1=&segs[key1->seg[j]];
+		seg2=&segs[key2->seg[j]];
+		for (s=0;;s++) {
+
+/*   even   */
+			if ((s==key1->nseg[j])&&(s==key2->nseg[j])) break;
+
+/*   index1 is shorter   */
+			if (s==key1->nseg[j]) return -1;
+
+/*   index2 is shorter   */
+			if (s==key2->nseg[j]) return 1;
+
+/*   priority   */
+			if ((priority!=0)&&(s>0)) {
+				if ((seg1[s].kana)&&(!seg2[s].kana))
+					return -1;
+
+				if ((seg2[s].kana)&&(!seg1[s].kana))
+					return 1;
+			}
+
+/*   compare group   */
+			if (seg1[s].order<seg2[s].order)
+				return -1;
+
+			if (seg1[s].order>seg2[s].order)
+				return 1;
+
+/*   simple compare   */
+			cmp=strcmp((char *)&keybuf[seg1[s].key],(char *)&keybuf[seg2[s].key]);
+			if (cmp<0) return -1;
+			else if (cmp>0) return 1;
+
+			if (priority==0) break;
+			if (seg1[s].len!=seg2[s].len) return wcomp_strcoll(p,q);
+		}
+
+/*   compare index   */
+		cmp=strcmp((char *)&keybuf[key1->idx[j]],(char *)&keybuf[key2->idx[j]]);
+		if (cmp<0) return -1;
+		else if (cmp>0) return 1;
+		cmp=u_strcmp((*index1).idx[j],(*index2).idx[j]);
+		if (cmp<0) return -1;
+		else if (cmp>0) return 1;
+	}
+	return 0;
+}
+
+/*   compare for sorting index, collating the strings directly   */
+static int wcomp_strcoll(const void *p, const void *q)
 {
 	int i, j, len1, len2, cmp;
 	const struct index *index1 = p, *index2 = q;
@@ -113,8 +280,6 @@ static int wcomp(const void *p, const void *q)
 	UChar *str1, *str2;
 	UCollationResult col_result;
 
-	scount++;
-
 	for (j=0;j<3;j++) {
 
 /*   check level   */
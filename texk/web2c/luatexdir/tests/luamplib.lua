@@ -0,0 +1,68 @@
+-- Checks the preload and reuse options of mplib.new: only instances that
+-- are finished at the outer level go back into the pool.
+
+local preload = "delimiters (); numeric runs; runs := 0;"
+
+local function new ()
+  return mplib.new { ini_version = true, math_mode = "scaled",
+                     preload = preload, reuse = true }
+end
+
+local function check (condition, message)
+  if not condition then
+    print("luamplib: " .. message)
+    os.exit(1)
+  end
+end
+
+local function shows (mp, value)
+  local r = mp:execute("runs := runs + 1; show runs;")
+  return r.status == 0 and r.term and r.term:find(">> " .. value, 1, true) ~= nil
+end
+
+local function keys (t)
+  local k = {}
+  for key in pairs(t) do k[#k + 1] = key end
+  table.sort(k)
+  return table.concat(k, " ")
+end
+
+-- A new instance runs the preload and returns its results.
+local mp, r = new()
+check(mp and r and r.status == 0, "preload failed")
+check(shows(mp, 1), "first run")
+local pooled = mp:finish()
+
+-- Finishing without reuse gives a result of the same shape.
+local plain = mplib.new { ini_version = true, math_mode = "scaled" }
+plain:execute(preload)
+local f = plain:finish()
+check(type(pooled) == "table" and pooled.status == f.status, "finish results")
+check(keys(pooled) == keys(f), "finish result fields: " .. keys(pooled) .. " / " .. keys(f))
+
+-- The pooled instance comes back without running the preload again.
+mp, r = new()
+check(mp and r == nil, "instance not pooled")
+check(shows(mp, 2), "pooled instance lost its state")
+
+-- An instance finished inside a group or figure is not pooled.
+mp:execute("begingroup")
+mp:finish()
+mp, r = new()
+check(mp and r and r.status == 0, "instance inside a group was pooled")
+check(shows(mp, 1), "fresh instance")
+
+-- Neither is an instance that is collected without a finish.
+mp = nil
+collectgarbage()
+mp, r = new()
+check(mp and r and r.status == 0, "collected instance was pooled")
+
+-- Nor one with errors.
+mp:execute("show runs +;")
+mp:finish()
+mp, r = new()
+check(mp and r and r.status == 0, "instance with errors was pooled")
+mp:finish()
+
+print("luamplib: ok")
@@ -0,0 +1,33 @@
+-- this file is part of the mplib package
+-- it times the lmplib library on the benchmark figures, one fresh
+-- instance per figure and number system
+-- usage: luatex --luaonly bench.lua scaled double -- plot.mp pens.mp
+
+local systems, files, seen = { }, { }, false
+for i = 1, #arg do
+    if arg[i] == "--" then
+        seen = true
+    elseif seen then
+        files[#files+1] = arg[i]
+    else
+        systems[#systems+1] = arg[i]
+    end
+end
+
+local function finder(name, mode, ftype)
+    return name
+end
+
+for _, name in ipairs(files) do
+    local f = assert(io.open(name, "rb"))
+    local data = f:read("*a")
+    f:close()
+    for _, ns in ipairs(systems) do
+        local t = os.clock()
+        local mp = mplib.new { math_mode = ns, find_file = finder }
+        local result = mp:execute(data)
+        mp:finish()
+        print(string.format("lmplib figure=%s numbersystem=%s status=%s %.3fs",
+            name, ns, tostring(result and result.status), os.clock() - t))
+    end
+end
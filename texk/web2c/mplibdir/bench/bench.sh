@@ -0,0 +1,49 @@
+#! /bin/sh
+# this file is part of the mplib package
+# it times mpost, and lmplib through luatex if present, on path-heavy figures
+# Compare the times before and after a change to the path or memory code
+
+echo "This is bench.sh"
+echo "[MPOST_PATH=/the/path/to/mpost ][LUATEX_PATH=/the/path/to/luatex ][MP_BENCH_SYSTEMS='scaled double' ]./bench.sh"
+
+test -z "$srcdir" && srcdir=`cd \`dirname $0\` && pwd`
+
+if test -z "$MPOST_PATH"
+then
+MPOST_PATH="$(which mpost)"
+fi
+if ! test -f "$MPOST_PATH" || ! test -x "$MPOST_PATH"
+then
+    echo "No executable file at $MPOST_PATH"
+    exit 1
+fi
+echo "mpost command used: $MPOST_PATH"
+
+if test -z "$LUATEX_PATH"
+then
+LUATEX_PATH="$(which luatex)"
+fi
+
+if test -z "$MP_BENCH_SYSTEMS"
+then
+MP_BENCH_SYSTEMS="scaled double decimal binary"
+fi
+
+mkdir -p mp_bench
+cd mp_bench
+for mp in $srcdir/*.mp
+do
+    cp "$mp" .
+    fig=`basename $mp .mp`
+    for ns in $MP_BENCH_SYSTEMS
+    do
+        echo "figure=$fig numbersystem=$ns"
+        time "$MPOST_PATH" -ini -interaction=nonstopmode -numbersystem=$ns $fig >/dev/null
+    done
+done
+if test -n "$LUATEX_PATH" && test -x "$LUATEX_PATH"
+then
+    echo "luatex command used: $LUATEX_PATH"
+    "$LUATEX_PATH" --luaonly "$srcdir/bench.lua" $MP_BENCH_SYSTEMS -- *.mp
+fi
+cd ..
@@ -64,6 +64,7 @@ int luaopen_mplib(lua_State * L);
 #define MPLIB_METATABLE     "MPlib.meta"
 #define MPLIB_FIG_METATABLE "MPlib.fig"
 #define MPLIB_GR_METATABLE  "MPlib.gr"
+#define MPLIB_POOL_METATABLE "MPlib.pool"
 
 #define is_mp(L,b) (MP *)luaL_checkudata(L,b,MPLIB_METATABLE)
 #define is_fig(L,b) (struct mp_edge_object **)luaL_checkudata(L,b,MPLIB_FIG_METATABLE)
@@ -295,6 +296,8 @@ typedef enum {
     P_SCRIPT_ERROR,
     P_EXTENSIONS,
     P_UTF8_MODE,
+    P_PRELOAD,
+    P_REUSE,
     P__SENTINEL
 } mplib_parm_idx;
 
@@ -318,6 +321,8 @@ static mplib_parm_struct mplib_parms[] = {
     {"extensions",   P_EXTENSIONS   },
     {"math_mode",    P_MATH_MODE    },
     {"utf8_mode",    P_UTF8_MODE    },
+    {"preload",      P_PRELOAD      },
+    {"reuse",        P_REUSE        },
     {NULL,           P__SENTINEL    }
 };
 
@@ -529,12 +534,125 @@ static int mplib_get_string(lua_State * L)
 
 #define xfree(A) if ((A)!=NULL) { free((A)); A = NULL; }
 
+/*tex
+
+    An instance can be given a |preload|, a chunk of \METAPOST\ code (normally
+    something like |input metafun ;|) that is executed once, right after the
+    instance is initialized. When also |reuse| is set, finishing such an instance
+    does not free it. It goes into a pool instead and a later |mplib.new| with the
+    same options and preload gets it back without running the preload again.
+    Everything defined in earlier runs then persists, so this is only meant for
+    instances that are used in the same way each time. Instances that are
+    collected without a |finish| are always freed.
+
+    The userdata starts with the |MP| pointer, so |is_mp| works as before. The
+    pool is kept per process; entries are keyed by the \LUA\ state too because
+    the instance calls back into the state it was created in.
+
+*/
+
+typedef struct mplib_instance {
+    MP mp;
+    char *reuse_key;
+} mplib_instance;
+
+typedef struct mplib_pool_entry {
+    lua_State *L;
+    char *key;
+    MP mp;
+    struct mplib_pool_entry *next;
+} mplib_pool_entry;
+
+static mplib_pool_entry *mplib_pool = NULL;
+
+static MP mplib_pool_take(lua_State * L, const char *key)
+{
+    mplib_pool_entry **p;
+    for (p = &mplib_pool; *p != NULL; p = &((*p)->next)) {
+        mplib_pool_entry *e = *p;
+        if (e->L == L && strcmp(e->key, key) == 0) {
+            MP mp = e->mp;
+            *p = e->next;
+            free(e->key);
+            free(e);
+            return mp;
+        }
+    }
+    return NULL;
+}
+
+/*tex
+
+    Only instances that are still usable and did not run into errors are kept,
+    as the history of an instance is never reset. They also have to be at the
+    outer level: an instance left inside a group or figure would start the next
+    run there.
+
+*/
+
+static int mplib_poolable(mplib_instance * ins)
+{
+    return ins->reuse_key != NULL && !mp_finished(ins->mp)
+        && mp_status(ins->mp) <= mp_warning_issued && mp_outer_level(ins->mp);
+}
+
+static int mplib_pool_put(lua_State * L, mplib_instance * ins)
+{
+    mplib_pool_entry *e;
+    if (!mplib_poolable(ins)) {
+        return 0;
+    }
+    e = malloc(sizeof(mplib_pool_entry));
+    if (e == NULL) {
+        return 0;
+    }
+    e->L = L;
+    e->key = ins->reuse_key;
+    e->mp = ins->mp;
+    e->next = mplib_pool;
+    mplib_pool = e;
+    ins->reuse_key = NULL;
+    ins->mp = NULL;
+    return 1;
+}
+
+/*tex
+
+    The pool sentinel is created when the library is opened, so it is collected
+    after all instances when the state is closed.
+
+*/
+
+static int mplib_pool_collect(lua_State * L)
+{
+    lua_State **owner = (lua_State **) luaL_checkudata(L, 1, MPLIB_POOL_METATABLE);
+    mplib_pool_entry **p = &mplib_pool;
+    while (*p != NULL) {
+        mplib_pool_entry *e = *p;
+        if (e->L == *owner) {
+            *p = e->next;
+            (void) mp_finish(e->mp);
+            free(e->key);
+            free(e);
+        } else {
+            p = &(e->next);
+        }
+    }
+    return 0;
+}
+
+static int mplib_wrapresults(lua_State * L, mp_run_data *res, int status);
+
 static int mplib_new(lua_State * L)
 {
     MP *mp_ptr;
-    mp_ptr = lua_newuserdata(L, sizeof(MP *));
+    mp_ptr = lua_newuserdata(L, sizeof(mplib_instance));
     if (mp_ptr) {
         int i;
+        int reuse = 0;
+        int preloaded = 0;
+        const char *preload = NULL;
+        mplib_instance *ins = (mplib_instance *) mp_ptr;
         struct MP_options *options = mp_options();
         options->userdata = (void *) L;
         /*tex Required: */
@@ -606,20 +724,59 @@ static int mplib_new(lua_State * L)
                     case P_UTF8_MODE:
                         options->utf8_mode = (int)lua_toboolean(L, -1);
                         break;
+                    case P_PRELOAD:
+                        /*tex The string stays anchored in the options table. */
+                        preload = lua_tostring(L, -1);
+                        break;
+                    case P_REUSE:
+                        reuse = lua_toboolean(L, -1);
+                        break;
                     default:
                         break;
                 }
                 lua_pop(L, 1);
             }
         }
-        *mp_ptr = mp_initialize(options);
+        ins->mp = NULL;
+        ins->reuse_key = NULL;
+        if (reuse && preload != NULL) {
+            lua_pushfstring(L, "%d %d %d %d %d %d %d %s\n%s",
+                options->error_line, options->max_print_line, options->random_seed,
+                options->interaction, options->math_mode, options->extensions,
+                options->utf8_mode, options->job_name == NULL ? "" : options->job_name,
+                preload);
+            ins->reuse_key = strdup(lua_tostring(L, -1));
+            lua_pop(L, 1);
+            ins->mp = mplib_pool_take(L, ins->reuse_key);
+        }
+        if (ins->mp == NULL) {
+            ins->mp = mp_initialize(options);
+            if (ins->mp != NULL && preload != NULL) {
+                char *s = xstrdup(preload);
+                int h = mp_execute(ins->mp, s, strlen(s));
+                free(s);
+                mplib_wrapresults(L, mp_rundata(ins->mp), h);
+                preloaded = 1;
+                if (h >= mp_fatal_error_stop) {
+                    (void) mp_finish(ins->mp);
+                    ins->mp = NULL;
+                }
+            }
+        }
         xfree(options->command_line);
         xfree(options->mem_name);
         free(options);
         if (*mp_ptr) {
             luaL_getmetatable(L, MPLIB_METATABLE);
-            lua_setmetatable(L, -2);
-            return 1;
+            lua_setmetatable(L, -2 - preloaded);
+            /*tex The results of the preload, if it was run, come second. */
+            return 1 + preloaded;
+        }
+        xfree(ins->reuse_key);
+        if (preloaded) {
+            lua_pushnil(L);
+            lua_insert(L, -2);
+            return 2;
         }
     }
     lua_pushnil(L);
@@ -633,6 +790,7 @@ static int mplib_collect(lua_State * L)
       (void)mp_finish(*mp_ptr);
       *mp_ptr = NULL;
     }
+    xfree(((mplib_instance *) mp_ptr)->reuse_key);
     return 0;
 }
 
@@ -715,11 +873,29 @@ static int mplib_finish(lua_State * L)
     MP *mp_ptr = is_mp(L, 1);
     if (*mp_ptr != NULL) {
         int i;
-        int h = mp_execute(*mp_ptr,NULL,0);
-        mp_run_data *res = mp_rundata(*mp_ptr);
+        int h;
+        mp_run_data *res;
+        if (mplib_poolable((mplib_instance *) mp_ptr)) {
+            /*tex
+                An instance that goes back into the pool is not terminated. A
+                chunk with only a comment is run instead, so that the results
+                are wrapped as usual. An empty one would ask for a command.
+            */
+            char *s = xstrdup("%");
+            h = mp_execute(*mp_ptr, s, 1);
+            free(s);
+            i = mplib_wrapresults(L, mp_rundata(*mp_ptr), h);
+            if (mplib_pool_put(L, (mplib_instance *) mp_ptr)) {
+                return i;
+            }
+            lua_pop(L, i);
+        }
+        h = mp_execute(*mp_ptr,NULL,0);
+        res = mp_rundata(*mp_ptr);
         i = mplib_wrapresults(L, res, h);
         (void)mp_finish(*mp_ptr);
         *mp_ptr = NULL;
+        xfree(((mplib_instance *) mp_ptr)->reuse_key);
         return i;
     } else {
         lua_pushnil(L);
@@ -2049,6 +2225,16 @@ int luaopen_mplib(lua_State * L)
     luaL_register(L, NULL, mplib_fig_meta);
     lua_pop(L, 1);
 
+    luaL_newmetatable(L, MPLIB_POOL_METATABLE);
+    lua_pushcfunction(L, mplib_pool_collect);
+    lua_setfield(L, -2, "__gc");
+    lua_pop(L, 1);
+
+    *((lua_State **) lua_newuserdata(L, sizeof(lua_State *))) = L;
+    luaL_getmetatable(L, MPLIB_POOL_METATABLE);
+    lua_setmetatable(L, -2);
+    lua_setfield(L, LUA_REGISTRYINDEX, "mplib.pool");
+
     luaL_newmetatable(L, MPLIB_METATABLE);
     lua_pushvalue(L, -1);
     lua_setfield(L, -2, "__index");
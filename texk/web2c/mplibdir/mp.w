@@ -677,6 +677,7 @@ extern MP_options *mp_options (void);
 extern MP mp_initialize (MP_options * opt);
 extern int mp_status (MP mp);
 extern boolean mp_finished (MP mp);
+extern boolean mp_outer_level (MP mp);
 extern void *mp_userdata (MP mp);
 
 @ @c
@@ -691,6 +692,16 @@ boolean mp_finished (MP mp) {
 }
 
 
+@ An instance is at the outer level when no group, conditional, loop or
+input level is open, for example before \&{beginfig} or after \&{endfig}.
+
+@c
+boolean mp_outer_level (MP mp) {
+  return mp->save_ptr == NULL && mp->cond_ptr == NULL
+    && mp->loop_ptr == NULL && mp->input_ptr == 0;
+}
+
+
 
 @ @c
 void *mp_userdata (MP mp) {
@@ -2845,7 +2856,6 @@ extern void *do_alloc_node(MP mp, size_t size);
 
 @d max_num_token_nodes 1000
 @d max_num_pair_nodes 1000
-@d max_num_knot_nodes 1000
 @d max_num_value_nodes 1000
 @d max_num_symbolic_nodes 1000
 
@@ -2854,8 +2864,8 @@ mp_node token_nodes;
 int num_token_nodes;
 mp_node pair_nodes;
 int num_pair_nodes;
-mp_knot knot_nodes;
-int num_knot_nodes;
+mp_knot knot_nodes; /* recycled knots, see |mp_new_knot| */
+mp_knot knot_blocks; /* the blocks those knots are carved from */
 mp_node value_nodes;
 int num_value_nodes;
 mp_node symbolic_nodes;
@@ -2867,7 +2877,7 @@ mp->num_token_nodes = 0;
 mp->pair_nodes = NULL;
 mp->num_pair_nodes = 0;
 mp->knot_nodes = NULL;
-mp->num_knot_nodes = 0;
+mp->knot_blocks = NULL;
 mp->value_nodes = NULL;
 mp->num_value_nodes = 0;
 mp->symbolic_nodes = NULL;
@@ -2894,11 +2904,7 @@ while (mp->token_nodes) {
       mp->token_nodes = p->link;
       mp_free_node(mp,p,token_node_size);
 }
-while (mp->knot_nodes) {
-      mp_knot p = mp->knot_nodes;
-      mp->knot_nodes = p->next;
-      mp_free_knot(mp,p);
-}
+mp_free_knot_blocks(mp);
 
 @ This is a nicer way of allocating nodes.
 
@@ -7410,26 +7416,83 @@ void mp_print_path (MP mp, mp_knot h, const char *s, boolean nuline) {
 }
 
 
-@ @<Declarations@>=
+@ @ Paths are copied and thrown away all the time, so knots do not go through
+|malloc| one by one. They are carved out of blocks of |knot_block_size| and
+recycled through the |knot_nodes| list, and only |mp_free| gives the blocks
+back. A recycled knot keeps its six numbers, which also saves allocating
+their payloads in the arbitrary-precision modes. The first knot of every
+block is never handed out; its |next| field chains the blocks together.
+
+@d knot_block_size 1000
+@d get_knot_node(A) do {
+  if (mp->knot_nodes == NULL)
+    mp_more_knot_nodes (mp);
+  A = mp->knot_nodes;
+  mp->knot_nodes = A->next;
+} while (0)
+@d reset_knot_number(A) do {
+  set_number_to_zero(A);
+  (A).type = mp_scaled_type;
+} while (0)
+@d copy_knot_number(A,B) do {
+  number_clone(A,B);
+  (A).type = mp_scaled_type;
+} while (0)
+
+@<Declarations@>=
+static void mp_more_knot_nodes (MP mp);
+static void mp_free_knot_blocks (MP mp);
 static mp_knot mp_new_knot (MP mp);
 
 @ @c
+static void mp_more_knot_nodes (MP mp) {
+  int k;
+  mp_knot b = mp_xmalloc (mp, knot_block_size, sizeof (struct mp_knot_data));
+  memset (b, 0, knot_block_size * sizeof (struct mp_knot_data));
+  b->next = mp->knot_blocks;
+  mp->knot_blocks = b;
+  for (k = knot_block_size - 1; k > 0; k--) {
+    new_number(b[k].x_coord);
+    new_number(b[k].y_coord);
+    new_number(b[k].left_x);
+    new_number(b[k].left_y);
+    new_number(b[k].right_x);
+    new_number(b[k].right_y);
+    b[k].next = mp->knot_nodes;
+    mp->knot_nodes = b + k;
+  }
+}
+static void mp_free_knot_blocks (MP mp) {
+  int k;
+  while (mp->knot_blocks) {
+    mp_knot b = mp->knot_blocks;
+    mp->knot_blocks = b->next;
+    if (mp->math_mode > mp_math_double_mode) {
+      for (k = 1; k < knot_block_size; k++) {
+        free_number (b[k].x_coord);
+        free_number (b[k].y_coord);
+        free_number (b[k].left_x);
+        free_number (b[k].left_y);
+        free_number (b[k].right_x);
+        free_number (b[k].right_y);
+      }
+    }
+    mp_xfree (b);
+  }
+  mp->knot_nodes = NULL;
+}
 static mp_knot mp_new_knot (MP mp) {
   mp_knot q;
-  if (mp->knot_nodes) {
-    q = mp->knot_nodes;
-    mp->knot_nodes = q->next;
-    mp->num_knot_nodes--;
-  } else {
-    q = mp_xmalloc (mp, 1, sizeof (struct mp_knot_data));
-  }
-  memset(q,0,sizeof (struct mp_knot_data));
-  new_number(q->x_coord);
-  new_number(q->y_coord);
-  new_number(q->left_x);
-  new_number(q->left_y);
-  new_number(q->right_x);
-  new_number(q->right_y);
+  get_knot_node (q);
+  q->next = NULL;
+  memset (&q->data, 0, sizeof (q->data));
+  q->originator = 0;
+  reset_knot_number(q->x_coord);
+  reset_knot_number(q->y_coord);
+  reset_knot_number(q->left_x);
+  reset_knot_number(q->left_y);
+  reset_knot_number(q->right_x);
+  reset_knot_number(q->right_y);
   return q;
 }
 
@@ -7449,27 +7512,18 @@ static mp_gr_knot mp_gr_new_knot (MP mp) {
 @c
 static mp_knot mp_copy_knot (MP mp, mp_knot p) {
   mp_knot q;
-  if (mp->knot_nodes) {
-    q  = mp->knot_nodes;
-    mp->knot_nodes = q->next;
-    mp->num_knot_nodes--;
-  } else {
-    q = mp_xmalloc (mp, 1, sizeof (struct mp_knot_data));
-  }
-  memcpy (q, p, sizeof (struct mp_knot_data));
+  get_knot_node (q);
   if (mp->math_mode > mp_math_double_mode) {
-    new_number(q->x_coord);
-    new_number(q->y_coord);
-    new_number(q->left_x);
-    new_number(q->left_y);
-    new_number(q->right_x);
-    new_number(q->right_y);
-    number_clone(q->x_coord, p->x_coord);
-    number_clone(q->y_coord, p->y_coord);
-    number_clone(q->left_x, p->left_x);
-    number_clone(q->left_y, p->left_y);
-    number_clone(q->right_x, p->right_x);
-    number_clone(q->right_y, p->right_y);
+    q->data = p->data;
+    q->originator = p->originator;
+    copy_knot_number(q->x_coord, p->x_coord);
+    copy_knot_number(q->y_coord, p->y_coord);
+    copy_knot_number(q->left_x, p->left_x);
+    copy_knot_number(q->left_y, p->left_y);
+    copy_knot_number(q->right_x, p->right_x);
+    copy_knot_number(q->right_y, p->right_y);
+  } else {
+    memcpy (q, p, sizeof (struct mp_knot_data));
   }
   mp_next_knot (q) = NULL;
   return q;
@@ -7644,30 +7698,14 @@ calling the following subroutine.
 @<Declarations@>=
 static void mp_toss_knot_list (MP mp, mp_knot p);
 static void mp_toss_knot (MP mp, mp_knot p);
-static void mp_free_knot (MP mp, mp_knot p);
 
-@ @c
-void mp_free_knot  (MP mp, mp_knot q) {
-  free_number (q->x_coord);
-  free_number (q->y_coord);
-  free_number (q->left_x);
-  free_number (q->left_y);
-  free_number (q->right_x);
-  free_number (q->right_y);
-  mp_xfree (q);
-}
+@ A knot, numbers and all, simply goes back on the |knot_nodes| list; it must
+never be passed to |mp_xfree|.
+
+@c
 void mp_toss_knot (MP mp, mp_knot q) {
-  if (mp->num_knot_nodes < max_num_knot_nodes) {
-    q->next = mp->knot_nodes;
-    mp->knot_nodes = q;
-    mp->num_knot_nodes++;
-    return;
-  }
-  if (mp->math_mode > mp_math_double_mode) {
-    mp_free_knot(mp,q);
-  } else {
-    mp_xfree (q);
-  }
+  q->next = mp->knot_nodes;
+  mp->knot_nodes = q;
 }
 void mp_toss_knot_list (MP mp, mp_knot p) {
   mp_knot q;    /* the node being freed */
@@ -7675,25 +7713,11 @@ void mp_toss_knot_list (MP mp, mp_knot p) {
   if (p == NULL)
     return;
   q = p;
-  if (mp->math_mode > mp_math_double_mode) {
-    do {
-      r = mp_next_knot (q);
-      mp_toss_knot(mp, q);
-      q = r;
-    } while (q != p);
-  } else {
-    do {
-      r = mp_next_knot (q);
-      if (mp->num_knot_nodes < max_num_knot_nodes) {
-        q->next = mp->knot_nodes;
-	mp->knot_nodes = q;
-	mp->num_knot_nodes++;
-      } else {
-        mp_xfree (q);
-      }
-      q = r;
-    } while (q != p);
-  }
+  do {
+    r = mp_next_knot (q);
+    mp_toss_knot(mp, q);
+    q = r;
+  } while (q != p);
 }
 
 
@@ -9022,12 +9046,12 @@ mp_knot mp_append_knot (MP mp, mp_knot p, double x, double y)
     mp_knot q = mp_create_knot(mp);
     if (q==NULL) return NULL;
     if (!mp_set_knot(mp, q, x, y)) {
-	free(q);
+	mp_toss_knot(mp, q);
 	return NULL;
     }
     if (p == NULL) return q;
     if (!mp_link_knotpair(mp, p,q)) {
-	free(q);
+	mp_toss_knot(mp, q);
 	return NULL;
     }
     return q;
@@ -10844,7 +10868,7 @@ where the |then| clause is not executed.
 @ @<Remove knot |p| and back up |p| and |q| but don't go past |l|@>=
 {
   s = mp_prev_knot (p);
-  mp_xfree (p);
+  mp_toss_knot (mp, p);
   mp_next_knot (s) = q;
   mp_prev_knot (q) = s;
   if (s == l) {
@@ -13591,7 +13615,7 @@ void mp_remove_cubic (MP mp, mp_knot p) {                               /* remov
   mp_next_knot (p) = mp_next_knot (q);
   number_clone (p->right_x, q->right_x);
   number_clone (p->right_y, q->right_y);
-  mp_xfree (q);
+  mp_toss_knot (mp, q);
 }
 
 
@@ -16054,6 +16078,251 @@ mp->tol = mp->tol - mp->three_l + (integer) mp->tol_step;
 mp->tol += mp->tol;
 mp->three_l = mp->three_l + (integer) mp->tol_step
 
+@ In the |double| number system an |mp_number| is a bare |double|, and going
+through the function pointers of the math library for every addition costs
+more than the arithmetic itself. The following routine therefore repeats
+|cubic_intersection| step by step on the |dval| fields of the same globals
+and stack entries, with the same rounding to |scaled| wherever the general
+routine converts; it finds exactly the same times. The other number systems
+keep using the general routine.
+
+@d dval(A) (A).data.dval
+@d dval_to_scaled(A) ((int)floor ((A) * 65536.0 + 0.5)) /* like |number_to_scaled| */
+@d dval_from_scaled(A) ((A) / 65536.0) /* like |set_number_from_scaled| */
+@d dval_bisect(A,B) /* split the packet |A| of the current level into |A-int_packets| and |A| of the next */
+  dval (stack_1 ((B) - int_packets)) = dval (stack_1 (A));
+  dval (stack_3 (B)) = dval (stack_3 (A));
+  dval (stack_2 ((B) - int_packets)) = (dval (stack_1 ((B) - int_packets)) + dval (stack_2 (A))) / 2.0;
+  dval (stack_2 (B)) = (dval (stack_3 (B)) + dval (stack_2 (A))) / 2.0;
+  dval (stack_3 ((B) - int_packets)) = (dval (stack_2 ((B) - int_packets)) + dval (stack_2 (B))) / 2.0;
+  dval (stack_1 (B)) = dval (stack_3 ((B) - int_packets));
+  mp_set_min_max_double (mp, (B) - int_packets);
+  mp_set_min_max_double (mp, (B))
+
+@c
+static void mp_set_min_max_double (MP mp, integer v) {
+  double a1 = dval (stack_1 (v));
+  double a2 = dval (stack_2 (v));
+  double a3 = dval (stack_3 (v));
+  double lo, hi;
+  if (a1 < 0) {
+    if (a3 >= 0) {
+      lo = (a2 < 0) ? a1 + a2 : a1;
+      hi = a1 + a2;
+      hi = hi + a3;
+      if (hi < 0)
+        hi = 0.0;
+    } else {
+      lo = a1 + a2;
+      lo = lo + a3;
+      if (lo > a1)
+        lo = a1;
+      hi = a1 + a2;
+      if (hi < 0)
+        hi = 0.0;
+    }
+  } else if (a3 <= 0) {
+    hi = (a2 > 0) ? a1 + a2 : a1;
+    lo = a1 + a2;
+    lo = lo + a3;
+    if (lo > 0)
+      lo = 0.0;
+  } else {
+    hi = a1 + a2;
+    hi = hi + a3;
+    if (hi < a1)
+      hi = a1;
+    lo = a1 + a2;
+    if (lo > 0)
+      lo = 0.0;
+  }
+  dval (stack_min (v)) = lo;
+  dval (stack_max (v)) = hi;
+}
+static void mp_cubic_intersection_double (MP mp, mp_knot p, mp_knot pp) {
+  mp_knot q, qq;        /* |mp_link(p)|, |mp_link(pp)| */
+  double x_two_t = dval (two_t) * 2.0 * 2.0; /* increment bit precision */
+  double x_two_t_low_precision = -0.5 + x_two_t; /* check for low precision */
+  double d;
+  mp->time_to_go = max_patience;
+  dval (mp->max_t) = dval_from_scaled (2);
+  q = mp_next_knot (p);
+  qq = mp_next_knot (pp);
+  mp->bisect_ptr = int_packets;
+  dval (u1r) = dval (p->right_x) - dval (p->x_coord);
+  dval (u2r) = dval (q->left_x) - dval (p->right_x);
+  dval (u3r) = dval (q->x_coord) - dval (q->left_x);
+  mp_set_min_max_double (mp, ur_packet);
+  dval (v1r) = dval (p->right_y) - dval (p->y_coord);
+  dval (v2r) = dval (q->left_y) - dval (p->right_y);
+  dval (v3r) = dval (q->y_coord) - dval (q->left_y);
+  mp_set_min_max_double (mp, vr_packet);
+  dval (x1r) = dval (pp->right_x) - dval (pp->x_coord);
+  dval (x2r) = dval (qq->left_x) - dval (pp->right_x);
+  dval (x3r) = dval (qq->x_coord) - dval (qq->left_x);
+  mp_set_min_max_double (mp, xr_packet);
+  dval (y1r) = dval (pp->right_y) - dval (pp->y_coord);
+  dval (y2r) = dval (qq->left_y) - dval (pp->right_y);
+  dval (y3r) = dval (qq->y_coord) - dval (qq->left_y);
+  mp_set_min_max_double (mp, yr_packet);
+  dval (mp->delx) = dval (p->x_coord) - dval (pp->x_coord);
+  dval (mp->dely) = dval (p->y_coord) - dval (pp->y_coord);
+  mp->tol = 0;
+  mp->uv = r_packets;
+  mp->xy = r_packets;
+  mp->three_l = 0;
+  dval (mp->cur_t) = dval_from_scaled (1);
+  dval (mp->cur_tt) = dval_from_scaled (1);
+CONTINUE:
+  while (1) {
+    if ( ((x_packet (mp->xy))+4)>bistack_size ||
+         ((u_packet (mp->uv))+4)>bistack_size ||
+         ((y_packet (mp->xy))+4)>bistack_size ||
+         ((v_packet (mp->uv))+4)>bistack_size ){
+      dval (mp->cur_t) = dval_from_scaled (1);
+      dval (mp->cur_tt) = dval_from_scaled (1);
+      goto NOT_FOUND;
+    }
+    if (dval (mp->max_t) > x_two_t) {
+      dval (mp->cur_t) = dval_from_scaled (1);
+      dval (mp->cur_tt) = dval_from_scaled (1);
+      goto NOT_FOUND;
+    }
+    if (dval_to_scaled (dval (mp->delx)) - mp->tol <=
+        dval_to_scaled (dval (stack_max (x_packet (mp->xy)))) - dval_to_scaled (dval (stack_min (u_packet (mp->uv)))))
+      if (dval_to_scaled (dval (mp->delx)) + mp->tol >=
+          dval_to_scaled (dval (stack_min (x_packet (mp->xy)))) - dval_to_scaled (dval (stack_max (u_packet (mp->uv)))))
+        if (dval_to_scaled (dval (mp->dely)) - mp->tol <=
+            dval_to_scaled (dval (stack_max (y_packet (mp->xy)))) - dval_to_scaled (dval (stack_min (v_packet (mp->uv)))))
+          if (dval_to_scaled (dval (mp->dely)) + mp->tol >=
+              dval_to_scaled (dval (stack_min (y_packet (mp->xy)))) - dval_to_scaled (dval (stack_max (v_packet (mp->uv))))) {
+            if (dval_to_scaled (dval (mp->cur_t)) >= dval_to_scaled (dval (mp->max_t))) {
+              if (dval (mp->max_t) == x_two_t || dval (mp->max_t) > x_two_t_low_precision) {
+                dval (mp->cur_t) = dval (mp->cur_t) / 4.0;
+                dval (mp->cur_tt) = dval (mp->cur_tt) / 4.0;
+                dval (mp->cur_t) = dval_from_scaled ((dval_to_scaled (dval (mp->cur_t)) + 1)/2);
+                dval (mp->cur_tt) = dval_from_scaled ((dval_to_scaled (dval (mp->cur_tt)) + 1)/2);
+                return;
+              }
+              dval (mp->max_t) = dval (mp->max_t) * 2.0;
+              dval (mp->appr_t) = dval (mp->cur_t);
+              dval (mp->appr_tt) = dval (mp->cur_tt);
+            }
+            /* Subdivide for a new level of intersection */
+            dval (stack_dx) = dval (mp->delx);
+            dval (stack_dy) = dval (mp->dely);
+            dval (stack_tol) = dval_from_scaled (mp->tol);
+            dval (stack_uv) = dval_from_scaled (mp->uv);
+            dval (stack_xy) = dval_from_scaled (mp->xy);
+            mp->bisect_ptr = mp->bisect_ptr + int_increment;
+            dval (mp->cur_t) = dval (mp->cur_t) * 2.0;
+            dval (mp->cur_tt) = dval (mp->cur_tt) * 2.0;
+            dval_bisect (u_packet (mp->uv), ur_packet);
+            dval_bisect (v_packet (mp->uv), vr_packet);
+            dval_bisect (x_packet (mp->xy), xr_packet);
+            dval_bisect (y_packet (mp->xy), yr_packet);
+            mp->uv = l_packets;
+            mp->xy = l_packets;
+            dval (mp->delx) = dval (mp->delx) * 2.0;
+            dval (mp->dely) = dval (mp->dely) * 2.0;
+            mp->tol = mp->tol - mp->three_l + (integer) mp->tol_step;
+            mp->tol += mp->tol;
+            mp->three_l = mp->three_l + (integer) mp->tol_step;
+            goto CONTINUE;
+          }
+    if (mp->time_to_go > 0) {
+      decr (mp->time_to_go);
+    } else {
+      dval (mp->appr_t) = dval (mp->appr_t) / 4.0;
+      dval (mp->appr_tt) = dval (mp->appr_tt) / 4.0;
+      while (dval (mp->appr_t) < dval (unity_t)) {
+        dval (mp->appr_t) = dval (mp->appr_t) * 2.0;
+        dval (mp->appr_tt) = dval (mp->appr_tt) * 2.0;
+      }
+      dval (mp->cur_t) = dval (mp->appr_t);
+      dval (mp->cur_tt) = dval (mp->appr_tt);
+      return;
+    }
+  NOT_FOUND:
+    if (odd (dval_to_scaled (dval (mp->cur_tt)))) {
+      if (odd (dval_to_scaled (dval (mp->cur_t)))) {
+        dval (mp->cur_t) = dval_from_scaled (half (dval_to_scaled (dval (mp->cur_t))));
+        dval (mp->cur_tt) = dval_from_scaled (half (dval_to_scaled (dval (mp->cur_tt))));
+        if (dval_to_scaled (dval (mp->cur_t)) == 0)
+          return;
+        mp->bisect_ptr -= int_increment;
+        mp->three_l -= (integer) mp->tol_step;
+        dval (mp->delx) = dval (stack_dx);
+        dval (mp->dely) = dval (stack_dy);
+        mp->tol = dval_to_scaled (dval (stack_tol));
+        mp->uv = dval_to_scaled (dval (stack_uv));
+        mp->xy = dval_to_scaled (dval (stack_xy));
+        goto NOT_FOUND;
+      } else {
+        dval (mp->cur_t) = dval_from_scaled (dval_to_scaled (dval (mp->cur_t)) + 1);
+        d = dval (mp->delx) + dval (stack_1 (u_packet (mp->uv)));
+        d = d + dval (stack_2 (u_packet (mp->uv)));
+        dval (mp->delx) = d + dval (stack_3 (u_packet (mp->uv)));
+        d = dval (mp->dely) + dval (stack_1 (v_packet (mp->uv)));
+        d = d + dval (stack_2 (v_packet (mp->uv)));
+        dval (mp->dely) = d + dval (stack_3 (v_packet (mp->uv)));
+        mp->uv = mp->uv + int_packets;      /* switch from |l_packets| to |r_packets| */
+        dval (mp->cur_tt) = dval_from_scaled (dval_to_scaled (dval (mp->cur_tt)) - 1);
+        mp->xy = mp->xy - int_packets;
+        d = dval (mp->delx) + dval (stack_1 (x_packet (mp->xy)));
+        d = d + dval (stack_2 (x_packet (mp->xy)));
+        dval (mp->delx) = d + dval (stack_3 (x_packet (mp->xy)));
+        d = dval (mp->dely) + dval (stack_1 (y_packet (mp->xy)));
+        d = d + dval (stack_2 (y_packet (mp->xy)));
+        dval (mp->dely) = d + dval (stack_3 (y_packet (mp->xy)));
+      }
+    } else {
+      dval (mp->cur_tt) = dval_from_scaled (dval_to_scaled (dval (mp->cur_tt)) + 1);
+      mp->tol = mp->tol + mp->three_l;
+      d = dval (mp->delx) - dval (stack_1 (x_packet (mp->xy)));
+      d = d - dval (stack_2 (x_packet (mp->xy)));
+      dval (mp->delx) = d - dval (stack_3 (x_packet (mp->xy)));
+      d = dval (mp->dely) - dval (stack_1 (y_packet (mp->xy)));
+      d = d - dval (stack_2 (y_packet (mp->xy)));
+      dval (mp->dely) = d - dval (stack_3 (y_packet (mp->xy)));
+      mp->xy = mp->xy + int_packets;        /* switch from |l_packets| to |r_packets| */
+    }
+  }
+}
+
+@ Before bisecting at all, |path_intersection| compares the bounding boxes
+of the control polygons; |cubic_intersection| rejects such a pair at level
+zero anyway, since its first overlap test is the same comparison done in
+|scaled| arithmetic. The |slack| covers the rounding of that test, so only
+pairs that cannot pass it are skipped, and the result does not change.
+With the box of the whole second path the inner loop can be skipped
+altogether for cubics that are nowhere near it.
+
+@d box_slack(A,B) (4.0 / 65536.0 + (fabs (A) + fabs (B)) * 1E-12)
+@d boxes_apart(A,B) (A[0] > B[2] + box_slack (A[0], B[2]) ||
+  B[0] > A[2] + box_slack (B[0], A[2]) ||
+  A[1] > B[3] + box_slack (A[1], B[3]) ||
+  B[1] > A[3] + box_slack (B[1], A[3]))
+
+@c
+static void mp_cubic_box_double (mp_knot p, double *box) {
+  mp_knot q = mp_next_knot (p);
+  double x[4], y[4];
+  int k;
+  x[0] = dval (p->x_coord); x[1] = dval (p->right_x);
+  x[2] = dval (q->left_x);  x[3] = dval (q->x_coord);
+  y[0] = dval (p->y_coord); y[1] = dval (p->right_y);
+  y[2] = dval (q->left_y);  y[3] = dval (q->y_coord);
+  box[0] = box[2] = x[0];
+  box[1] = box[3] = y[0];
+  for (k = 1; k < 4; k++) {
+    if (x[k] < box[0]) box[0] = x[k];
+    if (x[k] > box[2]) box[2] = x[k];
+    if (y[k] < box[1]) box[1] = y[k];
+    if (y[k] > box[3]) box[3] = y[k];
+  }
+}
+
 @ The |path_intersection| procedure is much simpler.
 It invokes |cubic_intersection| in lexicographic order until finding a
 pair of cubics that intersect. The final intersection times are placed in
@@ -16063,22 +16332,37 @@ pair of cubics that intersect. The final intersection times are placed in
 static void mp_path_intersection (MP mp, mp_knot h, mp_knot hh) {
   mp_knot p, pp;        /* link registers that traverse the given paths */
   mp_number n, nn;        /* integer parts of intersection times, minus |unity| */
+  boolean use_double = (mp->math_mode == mp_math_double_mode);
+  double box[4], bbox[4], hh_box[4]; /* boxes of |p|, |pp| and all of |hh| */
   @<Change one-point paths into dead cycles@>;
   new_number (n);
   new_number (nn);
+  if (use_double)
+    @<Find the box |hh_box| around all the cubics of |hh|@>;
   mp->tol_step = 0;
   do {
     set_number_to_unity(n);
     number_negate (n);
     p = h;
     do {
-      if (mp_right_type (p) != mp_endpoint) {
+      if (use_double && mp_right_type (p) != mp_endpoint)
+        mp_cubic_box_double (p, box);
+      if (mp_right_type (p) != mp_endpoint &&
+          !(use_double && boxes_apart (box, hh_box))) {
         set_number_to_unity(nn);
         number_negate (nn);
         pp = hh;
         do {
           if (mp_right_type (pp) != mp_endpoint) {
-            mp_cubic_intersection (mp, p, pp);
+            if (!use_double) {
+              mp_cubic_intersection (mp, p, pp);
+            } else {
+              mp_cubic_box_double (pp, bbox);
+              if (boxes_apart (box, bbox))
+                set_number_to_zero (mp->cur_t);
+              else
+                mp_cubic_intersection_double (mp, p, pp);
+            }
             if (number_positive (mp->cur_t)) {
               number_add (mp->cur_t, n);
               number_add (mp->cur_tt, nn);
@@ -16104,6 +16388,28 @@ DONE:
 }
 
 
+@ @<Find the box |hh_box|...@>=
+{
+  pp = hh;
+  hh_box[0] = hh_box[1] = 1.0;
+  hh_box[2] = hh_box[3] = -1.0; /* empty, if |hh| has no cubics */
+  do {
+    if (mp_right_type (pp) != mp_endpoint) {
+      mp_cubic_box_double (pp, bbox);
+      if (hh_box[0] > hh_box[2]) {
+        hh_box[0] = bbox[0]; hh_box[1] = bbox[1];
+        hh_box[2] = bbox[2]; hh_box[3] = bbox[3];
+      } else {
+        if (bbox[0] < hh_box[0]) hh_box[0] = bbox[0];
+        if (bbox[1] < hh_box[1]) hh_box[1] = bbox[1];
+        if (bbox[2] > hh_box[2]) hh_box[2] = bbox[2];
+        if (bbox[3] > hh_box[3]) hh_box[3] = bbox[3];
+      }
+    }
+    pp = mp_next_knot (pp);
+  } while (pp != hh);
+}
+
 @ @<Change one-point paths...@>=
 if (mp_right_type (h) == mp_endpoint) {
   number_clone (h->right_x, h->x_coord);
@@ -24827,7 +25133,7 @@ CONTINUE_PATH:
     mp_next_knot (path_q) = mp_next_knot (pp);
     number_clone (path_q->right_x, pp->right_x);
     number_clone (path_q->right_y, pp->right_y);
-    mp_xfree (pp);
+    mp_toss_knot (mp, pp);
     if (qq == pp)
       qq = path_q;
 
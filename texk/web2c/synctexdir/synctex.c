@@ -379,14 +379,12 @@ static int fsyscp_remove(char *name);
 #   include "zlib.h"
 
 typedef void (*synctex_recorder_t) (halfword);  /* recorders know how to record a node */
-typedef int (*synctex_fprintf_t) (void *, const char *, ...);   /* print formatted to either FILE * or gzFile */
 
 #   define SYNCTEX_BITS_PER_BYTE 8
 
 /*  Here are all the local variables gathered in one "synchronization context"  */
 static struct {
     void *file;                 /*  the foo.synctex or foo.synctex.gz I/O identifier  */
-    synctex_fprintf_t fprintf;  /*  either fprintf or gzprintf */
     char *busy_name;            /*  the real "foo.synctex(busy)" or "foo.synctex.gz(busy)" name, with output_directory  */
     char *root_name;            /*  in general jobname.tex  */
     integer count;              /*  The number of interesting records in "foo.synctex"  */
@@ -417,7 +415,7 @@ static struct {
         unsigned int reserved:SYNCTEX_BITS_PER_BYTE*sizeof(int)-8; /* Align */
     } flags;
 } synctex_ctxt = {
-    NULL, NULL, NULL, NULL, 0, 0, NULL, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, {0,0,0,0,0,0,0,0,0}}; /* last_v_recorded is initialized to -1. */
+    NULL, NULL, NULL, 0, 0, NULL, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, {0,0,0,0,0,0,0,0,0}}; /* last_v_recorded is initialized to -1. */
 
 #   define SYNCTEX_FILE synctex_ctxt.file
 #   define SYNCTEX_CONTENT_READY (synctex_ctxt.flags.content_ready)
@@ -425,7 +423,7 @@ static struct {
 #   define SYNCTEX_NO_GZ (synctex_ctxt.flags.no_gz)
 #   define SYNCTEX_NOT_VOID (synctex_ctxt.flags.not_void)
 #   define SYNCTEX_WARNING_DISABLE (synctex_ctxt.flags.warn)
-#   define SYNCTEX_fprintf (*synctex_ctxt.fprintf)
+#   define SYNCTEX_fprintf synctex_printf
 
 #   define SYNCTEX_IS_READY (synctex_ctxt.flags.ready)
 
@@ -434,6 +432,120 @@ static struct {
 #   define SYNCTEX_WITH_FORMS (((synctex_ctxt.options)&4)!=0)
 #   define SYNCTEX_H_COMPRESS (((synctex_ctxt.options)&8)!=0)
 
+/*  The records are formatted into a large buffer, which is written to the
+ *  file, compressed or not, only when full.  This saves a stdio or zlib call
+ *  per record, and zlib deflates big blocks at once.  */
+#   define SYNCTEX_BUFFER_SIZE 0x40000
+#   define SYNCTEX_RECORD_SIZE 256  /*  more than any record but for file names  */
+
+static struct {
+    char *start;
+    size_t length;              /*  number of bytes waiting in the buffer  */
+    size_t size;
+} synctex_buffer = {NULL, 0, 0};
+
+/*  Write the buffer to the file, return 0 on success.  */
+static int synctex_flush(void)
+{
+    size_t length = synctex_buffer.length;
+    synctex_buffer.length = 0;
+    if (length == 0 || !SYNCTEX_FILE) {
+        return 0;
+    }
+    if (SYNCTEX_NO_GZ) {
+        return fwrite(synctex_buffer.start, 1, length, (FILE *) SYNCTEX_FILE) == length ? 0 : -1;
+    }
+    return gzwrite((gzFile) SYNCTEX_FILE, synctex_buffer.start, (unsigned) length) == (int) length ? 0 : -1;
+}
+
+/*  Make room for size more bytes in the buffer, return 0 on success.  */
+static int synctex_reserve(size_t size)
+{
+    if (synctex_buffer.length + size <= synctex_buffer.size) {
+        return 0;
+    }
+    if (synctex_flush()) {
+        return -1;
+    }
+    if (size > synctex_buffer.size) {
+        size_t new_size = size > SYNCTEX_BUFFER_SIZE ? size : SYNCTEX_BUFFER_SIZE;
+        char *start = (char *) realloc(synctex_buffer.start, new_size);
+        if (!start) {
+            return -1;
+        }
+        synctex_buffer.start = start;
+        synctex_buffer.size = new_size;
+    }
+    return 0;
+}
+
+/*  Flush the buffer and close the file, return 0 on success.  */
+static int synctex_close(void)
+{
+    int ret = synctex_flush();
+    if (SYNCTEX_NO_GZ) {
+        xfclose((FILE *) SYNCTEX_FILE, synctex_ctxt.busy_name);
+    } else if (gzclose((gzFile) SYNCTEX_FILE) != Z_OK) {
+        ret = -1;
+    }
+    SYNCTEX_FILE = NULL;
+    return ret;
+}
+
+/*  A replacement for fprintf and gzprintf writing to the buffer.
+ *  Only the %i and %s conversions used by the records are supported.
+ *  Returns the number of bytes of the record, or -1 on error.  */
+static int synctex_printf(void *file __attribute__ ((unused)), const char *format, ...)
+{
+    va_list ap;
+    char *p;
+    char *start;
+    int length = 0;
+    if (synctex_reserve(SYNCTEX_RECORD_SIZE)) {
+        return -1;
+    }
+    va_start(ap, format);
+    p = start = synctex_buffer.start + synctex_buffer.length;
+    for (; *format; ++format) {
+        if (*format != '%') {
+            *p++ = *format;
+        } else if (*++format == 'i') {
+            int n = va_arg(ap, int);
+            unsigned int u = n < 0 ? 0u - (unsigned int) n : (unsigned int) n;
+            char digits[16];
+            char *d = digits + sizeof(digits);
+            do {
+                *--d = (char) ('0' + u % 10);
+                u /= 10;
+            } while (u);
+            if (n < 0) {
+                *p++ = '-';
+            }
+            while (d < digits + sizeof(digits)) {
+                *p++ = *d++;
+            }
+        } else if (*format == 's') {
+            const char *s = va_arg(ap, const char *);
+            size_t len = strlen(s);
+            /*  File names can be long: the buffer may be flushed here.  */
+            length += (int) (p - start);
+            synctex_buffer.length = (size_t) (p - synctex_buffer.start);
+            if (synctex_reserve(len + SYNCTEX_RECORD_SIZE)) {
+                va_end(ap);
+                return -1;
+            }
+            p = start = synctex_buffer.start + synctex_buffer.length;
+            memcpy(p, s, len);
+            p += len;
+        } else {
+            *p++ = *format;
+        }
+    }
+    va_end(ap);
+    synctex_buffer.length = (size_t) (p - synctex_buffer.start);
+    return length + (int) (p - start);
+}
+
 static inline void _synctex_read_command_line_option(void) {
 #   if SYNCTEX_DEBUG
     printf("\nSynchronize DEBUG: _synctex_read_command_line_option\n");
@@ -491,12 +603,7 @@ void synctexabort(boolean log_opened __attribute__ ((unused)))
     printf("\nSynchronize DEBUG: synctex_abort\n");
 #   endif
     if (SYNCTEX_FILE) {
-        if (SYNCTEX_NO_GZ) {
-            xfclose((FILE *) SYNCTEX_FILE, synctex_ctxt.busy_name);
-        } else {
-            gzclose((gzFile) SYNCTEX_FILE);
-        }
-        SYNCTEX_FILE = NULL;
+        synctex_close();
 #if defined(W32UPTEXSYNCTEX)
         fsyscp_remove(synctex_ctxt.busy_name);
 #else
@@ -678,10 +785,8 @@ static void *synctex_dot_open(void)
             strcat(the_busy_name, synctex_suffix_busy);
             if (SYNCTEX_NO_GZ) {
                 SYNCTEX_FILE = fopen(the_busy_name, FOPEN_W_MODE);
-                synctex_ctxt.fprintf = (synctex_fprintf_t) (&fprintf);
             } else {
                 SYNCTEX_FILE = gzopen(the_busy_name, FOPEN_WBIN_MODE);
-                synctex_ctxt.fprintf = (synctex_fprintf_t) (&gzprintf);
             }
 #   if SYNCTEX_DEBUG
             printf("\nwarning: Synchronize DEBUG: synctex_dot_open 2\n");
@@ -924,16 +1029,14 @@ void synctexterminate(boolean log_opened)
         }
         if (SYNCTEX_FILE) {
             if (SYNCTEX_NOT_VOID) {
-                synctex_record_postamble();
-                /* close the synctex file */
-                if (SYNCTEX_NO_GZ) {
-                    xfclose((FILE *) SYNCTEX_FILE, synctex_ctxt.busy_name);
-                } else {
-                    gzclose((gzFile) SYNCTEX_FILE);
-                }
-                SYNCTEX_FILE = NULL;
-                /*  renaming the working synctex file */
-                if (0 == rename(synctex_ctxt.busy_name, the_real_syncname)) {
+                if (synctex_record_postamble()) {
+                    /*  synctexabort has already removed the working synctex file */
+                } else if (synctex_close()) {
+                    /*  the working synctex file is truncated, don't rename it */
+                    fprintf(stderr, "SyncTeX: Can't write %s\n",
+                            synctex_ctxt.busy_name);
+                    remove(synctex_ctxt.busy_name);
+                } else if (0 == rename(synctex_ctxt.busy_name, the_real_syncname)) {
                     if (log_opened) {
                         tmp = the_real_syncname;
 #                       if SYNCTEX_DO_NOT_LOG_OUTPUT_DIRECTORY
@@ -979,12 +1082,7 @@ void synctexterminate(boolean log_opened)
                 }
             } else {
                 /* close and remove the synctex file because there are no pages of output */
-                if (SYNCTEX_NO_GZ) {
-                    xfclose((FILE *) SYNCTEX_FILE, synctex_ctxt.busy_name);
-                } else {
-                    gzclose((gzFile) SYNCTEX_FILE);
-                }
-                SYNCTEX_FILE = NULL;
+                synctex_close();
                 remove(synctex_ctxt.busy_name);
             }
         }
@@ -1030,12 +1128,7 @@ void synctexterminate(boolean log_opened)
         remove(the_real_syncname);
         if (SYNCTEX_FILE) {
             /* close the synctex file */
-            if (SYNCTEX_NO_GZ) {
-                xfclose((FILE *) SYNCTEX_FILE, synctex_ctxt.busy_name);
-            } else {
-                gzclose((gzFile) SYNCTEX_FILE);
-            }
-            SYNCTEX_FILE = NULL;
+            synctex_close();
             /*  removing the working synctex file */
             remove(synctex_ctxt.busy_name);
         }
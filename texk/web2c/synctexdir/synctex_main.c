@@ -116,10 +116,12 @@ void synctex_help(const char * error,...);
 void synctex_help_view(const char * error,...);
 void synctex_help_edit(const char * error,...);
 void synctex_help_update(const char * error,...);
+void synctex_help_index(const char * error,...);
 
 int synctex_view(int argc, char *argv[]);
 int synctex_edit(int argc, char *argv[]);
 int synctex_update(int argc, char *argv[]);
+int synctex_index(int argc, char *argv[]);
 int synctex_test(int argc, char *argv[]);
 
 int main(int argc, char *argv[])
@@ -138,6 +140,9 @@ int main(int argc, char *argv[])
                 } else if(0==strcmp("update",argv[arg_index])) {
                     synctex_help_update(NULL);
                     return 0;
+                } else if(0==strcmp("index",argv[arg_index])) {
+                    synctex_help_index(NULL);
+                    return 0;
                 }
             }
             synctex_help(NULL);
@@ -148,6 +153,8 @@ int main(int argc, char *argv[])
             return synctex_edit(argc-arg_index-1,argv+arg_index+1);
         } else if(0==strcmp("update",argv[arg_index])) {
             return synctex_update(argc-arg_index-1,argv+arg_index+1);
+        } else if(0==strcmp("index",argv[arg_index])) {
+            return synctex_index(argc-arg_index-1,argv+arg_index+1);
         } else if(0==strcmp("test",argv[arg_index])) {
             return synctex_test(argc-arg_index-1,argv+arg_index+1);
         }
@@ -182,6 +189,7 @@ void synctex_help(const char * error,...) {
         "   view     to perform forwards synchronization\n"
         "   edit     to perform backwards synchronization\n"
         "   update   to update a synctex file after a dvi/xdv to pdf filter\n"
+        "   index    to speed up view and edit for large documents\n"
         "   help     this help\n\n"
         "Type 'synctex help <subcommand>' for help on a specific subcommand.\n"
         "There is also an undocumented test subcommand.\n"
@@ -394,7 +402,10 @@ int synctex_view_proceed(synctex_view_params_t * Ps) {
         synctex_help_view("Viewer command is too long");
         return -1;
     }
-    scanner = synctex_scanner_new_with_output_file(Ps->output,Ps->directory,1);
+    scanner = synctex_scanner_new_with_output_file(Ps->output,Ps->directory,0);
+    /*  Use the index, if any, to parse only the relevant sheets */
+    synctex_scanner_index_display(scanner,Ps->input,Ps->line);
+    scanner = synctex_scanner_parse(scanner);
     if(scanner && synctex_display_query(scanner,Ps->input,Ps->line,Ps->column,Ps->page)) {
         synctex_node_p node = NULL;
         if((node = synctex_scanner_next_result(scanner)) != NULL) {
@@ -677,7 +688,10 @@ int synctex_edit_proceed(synctex_edit_params_t * Ps) {
     printf("context:%s\n",Ps->context);
     printf("cwd:%s\n",getcwd(NULL,0));
 #endif
-    scanner = synctex_scanner_new_with_output_file(Ps->output,Ps->directory,1);
+    scanner = synctex_scanner_new_with_output_file(Ps->output,Ps->directory,0);
+    /*  Use the index, if any, to parse only the relevant sheets */
+    synctex_scanner_index_edit(scanner,Ps->page);
+    scanner = synctex_scanner_parse(scanner);
     if(NULL == scanner) {
         synctex_help_edit("No SyncTeX available for %s",Ps->output);
         return -1;
@@ -878,6 +892,56 @@ next_argument:
     return 0;
 }
 
+void synctex_help_index(const char * error,...) {
+    va_list v;
+    va_start(v, error);
+    synctex_usage(error, v);
+    va_end(v);
+    fputs(
+        "synctex index: index a synctex file,\n"
+        "Use this command once the synctex file is complete, after any synctex update.\n"
+        "The view and edit subcommands then only parse the pages they need,\n"
+        "which is faster for large documents.\n"
+        "The index is saved next to the synctex file, with an additional .idx extension.\n"
+        "It is ignored once the synctex file has changed.\n"
+        "\n"
+        "usage: synctex index -o output [-d directory]\n"
+        "\n"
+        "-o output     is the full or relative path of an existing file,\n"
+        "              either the real synctex file you wish to index\n"
+        "              or a related file: foo.tex, foo.pdf, foo.dvi...\n"
+        "-d directory  is the directory containing the synctex file, in case it is different from the directory of the output.\n",
+        (error?stderr:stdout)
+        );
+    return;
+}
+
+/*  "usage: synctex index -o output [-d directory]\n"  */
+int synctex_index(int argc, char *argv[]) {
+    synctex_scanner_p scanner = NULL;
+    char * directory = NULL;
+    int status = 0;
+    if(argc<2 || strcmp("-o",argv[0])) {
+        synctex_help_index("Missing -o required argument");
+        return -1;
+    }
+    if(argc>2) {
+        if(strcmp("-d",argv[2])) {
+            synctex_help_index("Bad index command");
+            return -1;
+        }
+        directory = argc>3? argv[3]: getenv("SYNCTEX_BUILD_DIRECTORY");
+    }
+    scanner = synctex_scanner_new_with_output_file(argv[1],directory,0);
+    if(NULL == scanner) {
+        synctex_help_index("No SyncTeX available for %s",argv[1]);
+        return -1;
+    }
+    status = synctex_scanner_write_index(scanner);
+    synctex_scanner_free(scanner);
+    return status;
+}
+
 int synctex_test_file (int argc, char *argv[]);
 
 /*  "usage: synctex test subcommand options\n"  */
@@ -101,6 +101,7 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <sys/stat.h>
 
 #if defined(HAVE_LOCALE_H)
 #include <locale.h>
@@ -772,6 +773,53 @@ static synctex_reader_p synctex_reader_init_with_output_file(synctex_reader_p re
 #       define SYNCTEX_DECLARE_HANDLE
 #   endif
 
+#   ifdef SYNCTEX_NOTHING
+#       pragma mark -
+#       pragma mark INDEX
+#   endif
+/**
+ *  The index is a small text file next to the synctex file,
+ *  built by synctex_scanner_write_index.
+ *  It records where each sheet starts and ends in the uncompressed
+ *  synctex file, and for each sheet the range of lines of each input
+ *  it contains. With it, the parser can seek over the sheets that
+ *  a query will not look at.
+ */
+typedef struct {
+    int page;
+    long begin;         /*  offset of the "{page" line */
+    long end;           /*  offset of the line following "}page" */
+    int line_number;    /*  number of the line following "}page" */
+    int keep;           /*  the sheet defines or uses forms or inputs, it is always parsed */
+    synctex_bool_t selected;
+} synctex_index_sheet_s;
+
+typedef struct {
+    int sheet;          /*  index of the sheet in the sheets array */
+    int tag;
+    int min;
+    int max;
+} synctex_index_lines_s;
+
+typedef struct {
+    int tag;
+    int max;            /*  the biggest line number recorded in a sheet */
+    char * name;
+} synctex_index_input_s;
+
+typedef struct {
+    synctex_index_sheet_s * sheets;
+    int number_of_sheets;
+    synctex_index_lines_s * lines;
+    int number_of_lines;
+    synctex_index_input_s * inputs;
+    int number_of_inputs;
+    int next_sheet;         /*  the sheet expected next while parsing */
+    synctex_bool_t active;  /*  whether the parser skips unselected sheets */
+} synctex_index_s;
+
+typedef synctex_index_s * synctex_index_p;
+
 #   ifdef SYNCTEX_NOTHING
 #       pragma mark -
 #       pragma mark SCANNER
@@ -811,6 +859,7 @@ struct synctex_scanner_t {
     synctex_class_s class_[synctex_node_number_of_types]; /*  The classes of the nodes of the scanner */
     int display_switcher;
     char * display_prompt;
+    synctex_index_p index;  /*  The sheet index, if any */
 };
 
 /**
@@ -3778,6 +3827,7 @@ static synctex_status_t _synctex_scan_post_scriptum(synctex_scanner_p scanner);
 static synctex_status_t _synctex_scan_postamble(synctex_scanner_p scanner);
 static synctex_status_t _synctex_setup_visible_hbox(synctex_node_p box);
 static synctex_status_t _synctex_scan_content(synctex_scanner_p scanner);
+static synctex_bool_t _synctex_index_skip_sheet(synctex_scanner_p scanner);
 int synctex_scanner_pre_x_offset(synctex_scanner_p scanner);
 int synctex_scanner_pre_y_offset(synctex_scanner_p scanner);
 const char * synctex_scanner_get_output_fmt(synctex_scanner_p scanner);
@@ -5096,6 +5146,9 @@ main_loop:
 #       pragma mark + SCAN SHEET
 #   endif
             try_input = synctex_YES;
+            if (_synctex_index_skip_sheet(scanner)) {
+                goto main_loop;
+            }
             ns = _synctex_parse_new_sheet(scanner);
             if (ns.status == SYNCTEX_STATUS_OK) {
                 sheet = ns.node;
@@ -5999,6 +6052,415 @@ synctex_scanner_p synctex_scanner_new() {
     }
     return scanner;
 }
+#   ifdef SYNCTEX_NOTHING
+#       pragma mark -
+#       pragma mark Index
+#   endif
+
+/*  Returns array, enlarged if necessary to hold count+1 elements of the given size.
+ *  The capacity of the array is 8 or a power of 2. */
+static void * _synctex_index_reserve(void * array, int count, size_t size) {
+    if (count == 0) {
+        return realloc(array, 8*size);
+    }
+    if (count >= 8 && !(count & (count-1))) {
+        return realloc(array, 2*count*size);
+    }
+    return array;
+}
+
+static void _synctex_index_free(synctex_index_p index) {
+    if (index) {
+        int i;
+        for (i=0;i<index->number_of_inputs;++i) {
+            free(index->inputs[i].name);
+        }
+        free(index->inputs);
+        free(index->sheets);
+        free(index->lines);
+        free(index);
+    }
+}
+
+static char * _synctex_index_name(synctex_scanner_p scanner) {
+    char * name = NULL;
+    if (scanner && scanner->reader && scanner->reader->synctex
+        && (name = malloc(strlen(scanner->reader->synctex)+5))) {
+        strcpy(name,scanner->reader->synctex);
+        strcat(name,".idx");
+    }
+    return name;
+}
+
+/*  The stamp identifies the synctex file the index was built from.
+ *  In particular, "synctex update" appends to the synctex file,
+ *  which makes the index obsolete. */
+static int _synctex_index_stamp(synctex_scanner_p scanner, long * size, long * mtime) {
+    struct stat buf;
+    if (stat(scanner->reader->synctex, &buf)) {
+        return -1;
+    }
+    *size = (long)buf.st_size;
+    *mtime = (long)buf.st_mtime;
+    return 0;
+}
+
+static synctex_status_t _synctex_index_add_input(synctex_index_p index, int tag, int max, const char * name) {
+    size_t length = strcspn(name,"\r\n");
+    synctex_index_input_s * input;
+    if (!(input = _synctex_index_reserve(index->inputs, index->number_of_inputs, sizeof(synctex_index_input_s)))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->inputs = input;
+    input += index->number_of_inputs;
+    if (!(input->name = malloc(length+1))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    memcpy(input->name, name, length);
+    input->name[length] = '\0';
+    input->tag = tag;
+    input->max = max;
+    ++index->number_of_inputs;
+    return SYNCTEX_STATUS_OK;
+}
+
+static synctex_status_t _synctex_index_add_sheet(synctex_index_p index, int page, long begin) {
+    synctex_index_sheet_s * sheet;
+    if (!(sheet = _synctex_index_reserve(index->sheets, index->number_of_sheets, sizeof(synctex_index_sheet_s)))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->sheets = sheet;
+    sheet += index->number_of_sheets++;
+    memset(sheet, 0, sizeof(synctex_index_sheet_s));
+    sheet->page = page;
+    sheet->begin = sheet->end = begin;
+    return SYNCTEX_STATUS_OK;
+}
+
+/*  Records that the given sheet contains the given line of input tag.
+ *  The entries of a sheet are consecutive and there are only a few of them. */
+static synctex_status_t _synctex_index_add_line(synctex_index_p index, int sheet, int tag, int line) {
+    synctex_index_lines_s * lines;
+    int i = index->number_of_lines;
+    while (i-- > 0 && index->lines[i].sheet == sheet) {
+        if (index->lines[i].tag == tag) {
+            if (line < index->lines[i].min) {
+                index->lines[i].min = line;
+            } else if (line > index->lines[i].max) {
+                index->lines[i].max = line;
+            }
+            return SYNCTEX_STATUS_OK;
+        }
+    }
+    if (!(lines = _synctex_index_reserve(index->lines, index->number_of_lines, sizeof(synctex_index_lines_s)))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->lines = lines;
+    lines += index->number_of_lines++;
+    lines->sheet = sheet;
+    lines->tag = tag;
+    lines->min = lines->max = line;
+    return SYNCTEX_STATUS_OK;
+}
+
+/*  Scans the synctex file line by line, without building any node. */
+static synctex_index_p _synctex_index_build(const char * synctex) {
+    char buffer[4096];
+    gzFile file;
+    synctex_index_p index;
+    long offset = 0;
+    long line_offset = 0;
+    int line_number = 1;
+    int sheet = -1;
+    int form_depth = 0;
+    synctex_bool_t in_content = synctex_NO;
+    synctex_bool_t at_line_start = synctex_YES;
+    synctex_bool_t end_of_sheet = synctex_NO;
+    synctex_status_t status = SYNCTEX_STATUS_OK;
+    if (!(file = gzopen(synctex,"rb"))) {
+        return NULL;
+    }
+    if (!(index = _synctex_malloc(sizeof(synctex_index_s)))) {
+        gzclose(file);
+        return NULL;
+    }
+    while (status == SYNCTEX_STATUS_OK && gzgets(file, buffer, sizeof(buffer))) {
+        size_t length = strlen(buffer);
+        synctex_bool_t complete = length>0 && buffer[length-1]=='\n';
+        if (at_line_start) {
+            char c = buffer[0];
+            line_offset = offset;
+            if (0 == strncmp(buffer,"Input:",6)) {
+                char * end = NULL;
+                int tag = (int)strtol(buffer+6,&end,10);
+                if (end && *end == ':') {
+                    status = _synctex_index_add_input(index,tag,0,end+1);
+                }
+                if (sheet>=0) {
+                    index->sheets[sheet].keep = 1;
+                }
+            } else if (!in_content) {
+                in_content = 0 == strncmp(buffer,"Content:",8);
+            } else if (0 == strncmp(buffer,"Postamble:",10)) {
+                break;
+            } else if (c == SYNCTEX_CHAR_BEGIN_SHEET && sheet<0) {
+                sheet = index->number_of_sheets;
+                status = _synctex_index_add_sheet(index,(int)strtol(buffer+1,NULL,10),line_offset);
+            } else if (c == SYNCTEX_CHAR_END_SHEET && sheet>=0) {
+                end_of_sheet = synctex_YES;
+            } else if (c == SYNCTEX_CHAR_BEGIN_FORM) {
+                ++form_depth;
+                if (sheet>=0) {
+                    index->sheets[sheet].keep = 1;
+                }
+            } else if (c == SYNCTEX_CHAR_END_FORM) {
+                --form_depth;
+            } else if (c == SYNCTEX_CHAR_FORM_REF && sheet>=0) {
+                index->sheets[sheet].keep = 1;
+            } else if (c && strchr("[(vhkgr$x",c) && sheet>=0 && form_depth == 0) {
+                /*  The records registered as lines of an input while parsing */
+                char * end = NULL;
+                int tag = (int)strtol(buffer+1,&end,10);
+                if (end && *end == ',') {
+                    status = _synctex_index_add_line(index,sheet,tag,(int)strtol(end+1,NULL,10));
+                }
+            }
+        }
+        offset += (long)length;
+        if (complete) {
+            ++line_number;
+            if (end_of_sheet) {
+                index->sheets[sheet].end = offset;
+                index->sheets[sheet].line_number = line_number;
+                end_of_sheet = synctex_NO;
+                sheet = -1;
+            }
+        }
+        at_line_start = complete;
+    }
+    gzclose(file);
+    if (status < SYNCTEX_STATUS_OK || sheet >= 0) {
+        /*  Out of memory or incomplete sheet */
+        _synctex_index_free(index);
+        return NULL;
+    }
+    /*  Now compute the maximal line of each input. */
+    {
+        int i, j;
+        for (i=0;i<index->number_of_inputs;++i) {
+            for (j=0;j<index->number_of_lines;++j) {
+                if (index->lines[j].tag == index->inputs[i].tag
+                    && index->lines[j].max > index->inputs[i].max) {
+                    index->inputs[i].max = index->lines[j].max;
+                }
+            }
+        }
+    }
+    return index;
+}
+
+int synctex_scanner_write_index(synctex_scanner_p scanner) {
+    synctex_index_p index = NULL;
+    char * name = NULL;
+    FILE * file = NULL;
+    long size, mtime;
+    int i;
+    if (!(name = _synctex_index_name(scanner))
+        || _synctex_index_stamp(scanner,&size,&mtime)
+        || !(index = _synctex_index_build(scanner->reader->synctex))) {
+        free(name);
+        return -1;
+    }
+    if (!(file = fopen(name,"w"))) {
+        _synctex_error("Can't write %s",name);
+        _synctex_index_free(index);
+        free(name);
+        return -1;
+    }
+    fprintf(file,"SyncTeX Index:1\nStamp:%ld:%ld\n",size,mtime);
+    for (i=0;i<index->number_of_inputs;++i) {
+        fprintf(file,"Input:%i:%i:%s\n",index->inputs[i].tag,index->inputs[i].max,index->inputs[i].name);
+    }
+    for (i=0;i<index->number_of_sheets;++i) {
+        synctex_index_sheet_s * sheet = index->sheets+i;
+        fprintf(file,"Sheet:%i:%ld:%ld:%i:%i\n",sheet->page,sheet->begin,sheet->end,sheet->line_number,sheet->keep);
+    }
+    for (i=0;i<index->number_of_lines;++i) {
+        synctex_index_lines_s * lines = index->lines+i;
+        fprintf(file,"Lines:%i:%i:%i:%i\n",lines->sheet,lines->tag,lines->min,lines->max);
+    }
+    i = ferror(file);
+    if (fclose(file) || i) {
+        remove(name);
+        i = -1;
+    }
+    _synctex_index_free(index);
+    free(name);
+    return i;
+}
+
+/*  Reads the index of the scanner, if it exists and is up to date. */
+static synctex_index_p _synctex_scanner_index(synctex_scanner_p scanner) {
+    char line[4096];
+    char * name = NULL;
+    FILE * file = NULL;
+    synctex_index_p index = NULL;
+    synctex_status_t status = SYNCTEX_STATUS_OK;
+    long size, mtime, index_size, index_mtime;
+    if (!scanner || scanner->flags.has_parsed) {
+        return NULL;
+    }
+    if (scanner->index) {
+        return scanner->index;
+    }
+    if (!(name = _synctex_index_name(scanner))
+        || _synctex_index_stamp(scanner,&size,&mtime)
+        || !(file = fopen(name,"r"))) {
+        free(name);
+        return NULL;
+    }
+    free(name);
+    if (!fgets(line,sizeof(line),file) || strcmp(line,"SyncTeX Index:1\n")
+        || !fgets(line,sizeof(line),file)
+        || sscanf(line,"Stamp:%ld:%ld",&index_size,&index_mtime) != 2
+        || index_size != size || index_mtime != mtime
+        || !(index = _synctex_malloc(sizeof(synctex_index_s)))) {
+        fclose(file);
+        return NULL;
+    }
+    while (status == SYNCTEX_STATUS_OK && fgets(line,sizeof(line),file)) {
+        int n = 0, a, b, c, d;
+        long begin, end;
+        if (sscanf(line,"Input:%i:%i:%n",&a,&b,&n) == 2 && n>0) {
+            status = _synctex_index_add_input(index,a,b,line+n);
+        } else if (sscanf(line,"Sheet:%i:%ld:%ld:%i:%i",&a,&begin,&end,&c,&d) == 5) {
+            if ((status = _synctex_index_add_sheet(index,a,begin)) == SYNCTEX_STATUS_OK) {
+                index->sheets[index->number_of_sheets-1].end = end;
+                index->sheets[index->number_of_sheets-1].line_number = c;
+                index->sheets[index->number_of_sheets-1].keep = d;
+            }
+        } else if (sscanf(line,"Lines:%i:%i:%i:%i",&a,&b,&c,&d) == 4
+                   && a>=0 && a<index->number_of_sheets) {
+            if ((status = _synctex_index_add_line(index,a,b,c)) == SYNCTEX_STATUS_OK) {
+                index->lines[index->number_of_lines-1].max = d;
+            }
+        } else {
+            status = SYNCTEX_STATUS_ERROR;
+        }
+    }
+    fclose(file);
+    if (status < SYNCTEX_STATUS_OK) {
+        _synctex_index_free(index);
+        return NULL;
+    }
+    return scanner->index = index;
+}
+
+int synctex_scanner_index_edit(synctex_scanner_p scanner, int page) {
+    synctex_index_p index = _synctex_scanner_index(scanner);
+    int i;
+    if (!index) {
+        return 0;
+    }
+    for (i=0;i<index->number_of_sheets;++i) {
+        if (index->sheets[i].page == page) {
+            index->sheets[i].selected = synctex_YES;
+        }
+    }
+    index->active = synctex_YES;
+    return 1;
+}
+
+int synctex_scanner_index_display(synctex_scanner_p scanner, const char * name, int line) {
+    synctex_index_p index = _synctex_scanner_index(scanner);
+    const char * base = NULL;
+    int i, j;
+    if (!index || !name) {
+        return 0;
+    }
+    /*  Select all the inputs that synctex_scanner_get_tag may choose:
+     *  they all share the base name. Then select the sheets with lines
+     *  the display query may try, it looks for the nearest line with
+     *  a result after clipping to the last line of the input. */
+    base = _synctex_base_name(name);
+    for (i=0;i<index->number_of_inputs;++i) {
+        synctex_index_input_s * input = index->inputs+i;
+        if (_synctex_is_equivalent_file_name(base,_synctex_base_name(input->name))) {
+            int from = (line<input->max? line: input->max) - 200;
+            int to = line + 200;
+            for (j=0;j<index->number_of_lines;++j) {
+                synctex_index_lines_s * lines = index->lines+j;
+                if (lines->tag == input->tag && lines->max >= from && lines->min <= to) {
+                    index->sheets[lines->sheet].selected = synctex_YES;
+                }
+            }
+        }
+    }
+    index->active = synctex_YES;
+    return 1;
+}
+
+/*  Used when parsing the synctex file, SYNCTEX_CUR points to the beginning of a sheet.
+ *  When the index tells that the sheet was not selected, move after its end
+ *  and return synctex_YES. */
+static synctex_bool_t _synctex_index_skip_sheet(synctex_scanner_p scanner) {
+    synctex_index_p index = scanner->index;
+    synctex_index_sheet_s * sheet;
+    long offset, read;
+    if (!index || !index->active || !SYNCTEX_FILE) {
+        return synctex_NO;
+    }
+    if (index->next_sheet >= index->number_of_sheets) {
+        index->active = synctex_NO;
+        return synctex_NO;
+    }
+    sheet = index->sheets + index->next_sheet++;
+    read = (long)gztell(SYNCTEX_FILE);
+    offset = read - (long)(SYNCTEX_END - SYNCTEX_CUR);
+    if (offset != sheet->begin) {
+        _synctex_error("The index does not match the synctex file.");
+        index->active = synctex_NO;
+        return synctex_NO;
+    }
+    if (sheet->selected || sheet->keep) {
+        return synctex_NO;
+    }
+    if (sheet->end <= read) {
+        SYNCTEX_CUR += sheet->end - offset;
+    } else {
+        if (gzseek(SYNCTEX_FILE, (z_off_t)sheet->end, SEEK_SET) < 0) {
+            index->active = synctex_NO;
+            return synctex_NO;
+        }
+#   if defined(SYNCTEX_USE_CHARINDEX)
+        scanner->reader->charindex_offset = sheet->end - (SYNCTEX_END - SYNCTEX_START);
+#   endif
+        /*  The buffer is empty, it will be filled from the new position. */
+        SYNCTEX_CUR = SYNCTEX_END;
+    }
+    scanner->reader->line_number = sheet->line_number;
+    return synctex_YES;
+}
+
+/*  The inputs record the last line seen in a sheet.
+ *  Give them the value they would have after parsing all the sheets. */
+static void _synctex_index_fix_inputs(synctex_scanner_p scanner) {
+    synctex_node_p input = scanner->input;
+    int i;
+    if (!scanner->index) {
+        return;
+    }
+    while (input) {
+        for (i=0;i<scanner->index->number_of_inputs;++i) {
+            if (scanner->index->inputs[i].tag == _synctex_data_tag(input)
+                && scanner->index->inputs[i].max > _synctex_data_line(input)) {
+                _synctex_data_set_line(input,scanner->index->inputs[i].max);
+            }
+        }
+        input = __synctex_tree_sibling(input);
+    }
+}
+
 /*  Where the synctex scanner is created. */
 synctex_scanner_p synctex_scanner_new_with_output_file(const char * output, const char * build_directory, int parse) {
     synctex_scanner_p scanner = synctex_scanner_new();
@@ -6031,6 +6493,7 @@ int synctex_scanner_free(synctex_scanner_p scanner) {
         synctex_iterator_free(scanner->iterator);
         free(scanner->output_fmt);
         free(scanner->lists_of_friends);
+        _synctex_index_free(scanner->index);
 #if SYNCTEX_USE_NODE_COUNT>0
         node_count = scanner->node_count;
 #endif
@@ -6085,6 +6548,7 @@ synctex_scanner_p synctex_scanner_parse(synctex_scanner_p scanner) {
         _synctex_error("Bad content\n");
         goto bailey;
     }
+    _synctex_index_fix_inputs(scanner);
     status = _synctex_scan_postamble(scanner);
     if (status<SYNCTEX_STATUS_OK) {
         _synctex_error("Bad postamble. Ignored\n");
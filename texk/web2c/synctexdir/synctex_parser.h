@@ -137,6 +137,32 @@ extern "C" {
      */
     synctex_scanner_p synctex_scanner_parse(synctex_scanner_p scanner);
     
+    /**
+     *  Large documents take time to parse, but a query only
+     *  looks at a few sheets. synctex_scanner_write_index saves
+     *  next to the synctex file an index of its sheets and of
+     *  the input lines they contain, to be built once after
+     *  each typesetting, for example with "synctex index".
+     *  Before parsing, send synctex_scanner_index_display or
+     *  synctex_scanner_index_edit with the arguments of the
+     *  forthcoming query: only the sheets that this query may
+     *  use are then parsed. These messages can be sent more
+     *  than once to prepare different queries.
+     *  Usage:
+     *      scanner = synctex_scanner_new_with_output_file(output,NULL,0);
+     *      synctex_scanner_index_display(scanner,name,line);
+     *      if ((scanner = synctex_scanner_parse(scanner))
+     *          && synctex_display_query(scanner,name,line,column,page_hint)>0) {
+     *          ...
+     *  The results are the same as without an index.
+     *  - returns: synctex_scanner_write_index returns 0 on success,
+     *      the others return 0 when no up to date index is available,
+     *      in which case the whole file will be parsed.
+     */
+    int synctex_scanner_write_index(synctex_scanner_p scanner);
+    int synctex_scanner_index_display(synctex_scanner_p scanner, const char * name, int line);
+    int synctex_scanner_index_edit(synctex_scanner_p scanner, int page);
+    
     /*  synctex_node_p is the type for all synctex nodes.
      *  Its implementation is considered private.
      *  The synctex file is parsed into a tree of nodes, either sheet, form, boxes, math nodes... */
@@ -0,0 +1,55 @@
+#! /bin/sh
+# this file is part of the synctex package
+# it times the overhead of the SyncTeX recorder on a long document
+# This script can be sourced with "pdftex" command available
+# Compare the "synctex=0" time with the other ones
+# The document is plain initex input and needs only cmr10.tfm,
+# e.g. from the build tree: TFMFONTS=/path/to/texk/web2c/tests
+
+echo "This is bench.sh"
+echo "You can source this file or execute it"
+echo "[PDFTEX_PATH=/the/path/to/pdftex ][SYNCTEX_BENCH_PARAGRAPHS=20000 ](source |./)bench.sh"
+
+if test -z "$PDFTEX_PATH"
+then
+PDFTEX_PATH="$(which pdftex)"
+fi
+if ! test -f "$PDFTEX_PATH" || ! test -x "$PDFTEX_PATH"
+then
+    echo "No executable file at $PDFTEX_PATH"
+    exit 1
+fi
+echo "pdftex command used: $PDFTEX_PATH"
+
+if test -z "$SYNCTEX_BENCH_PARAGRAPHS"
+then
+SYNCTEX_BENCH_PARAGRAPHS=20000
+fi
+
+mkdir -p synctex_bench
+cd synctex_bench
+cat > bench.tex <<TEX
+\catcode\`\{=1 \catcode\`\}=2 \catcode\`\#=6
+\pdfoutput=0
+\font\rm=cmr10 \rm
+\hsize=300pt \vsize=500pt \parindent=10pt \baselineskip=12pt
+\tolerance=10000 \hbadness=10000 \parfillskip=0pt plus 1fil
+\def\para{Lorem ipsum dolor sit amet, consectetur adipisci elit, sed
+  eiusmod tempor incidunt ut labore et dolore magna aliqua.
+  \hbox{boxed \vbox{\hbox{text}}} \vrule width 2pt height 4pt \kern3pt
+  Ut enim ad minim veniam, quis nostrum exercitationem ullam corporis.\par}
+\count1=0
+\def\loop{\ifnum\count1<$SYNCTEX_BENCH_PARAGRAPHS \advance\count1 by 1 \para
+  \expandafter\loop\fi}
+\loop
+\end
+TEX
+
+for synctex in 0 1 -1
+do
+    rm -f bench.synctex bench.synctex.gz
+    echo "synctex=$synctex"
+    time "$PDFTEX_PATH" -ini -interaction=batchmode -synctex=$synctex bench.tex >/dev/null
+done
+ls -l bench.synctex*
+cd ..
@@ -6,6 +6,10 @@
  *****/
 
 #include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cerrno>
+#include <sys/stat.h>
 
 #include "drawlabel.h"
 #include "settings.h"
@@ -16,86 +20,267 @@ using namespace settings;
 
 namespace camp {
 
-string texready=string("(Please type a command or say `\\end')\n*");
-
 void drawLabel::labelwarning(const char *action)
 {
   cerr << "warning: label \"" << label
        << "\" " << action << " to avoid overwriting" << endl;
 }
 
-// Reads one of the dimensions from the pipe.
-void texdim(iopipestream& tex, double& dest, const string command,
-            const string name)
+// Label dimensions measured by TeX, indexed by labelkey().  If the setting
+// labelcache is true, the entries are also kept in the file
+// initdir/labelcache, so that unchanged labels are not measured again in
+// later runs.
+struct labeldims {
+  double width,height,depth;
+};
+
+typedef mem::map<CONST string,labeldims> labeldimsMap;
+labeldimsMap labeldimsCache;
+bool labeldimsLoaded=false;
+
+string labelcachename()
 {
-  string start(">dim(");
-  string stop(")dim");
-  string expect("pt"+stop+"\n\n*");
-
-  // ask the tex engine for dimension
-  tex << "\\immediate\\write16{" << start << "\\the\\" << command << "\\ASYbox"
-      << stop << "}\n";
-  // keep reading output until ')dim\n\n*' is read
-  tex.wait(expect.c_str());
-  string buffer = tex.getbuffer();
-
-  size_t dim1=buffer.find(start);
-  size_t dim2=buffer.find("pt" + stop);
-  string cannotread="Cannot read label "+name;
-  if (dim1 != string::npos && dim2 != string::npos) {
-    string n=buffer.substr(dim1+start.size(),dim2-dim1-start.size());
-    try {
-      dest=lexical::cast<double>(n,true)*tex2ps;
-    } catch(lexical::bad_cast&) {
-      camp::reportError(cannotread);
-    }
-  } else {
-    camp::reportError(cannotread);
+  return initdir+"/labelcache";
+}
+
+// Cache file entries are single lines, so escape backslashes and newlines.
+string escapekey(const string& s)
+{
+  string r;
+  for(size_t i=0; i < s.size(); ++i) {
+    if(s[i] == '\\') r += "\\\\";
+    else if(s[i] == '\n') r += "\\n";
+    else r += s[i];
   }
+  return r;
 }
 
-void texbounds(double& width, double& height, double& depth,
-               iopipestream& tex, string& s)
+string unescapekey(const string& s)
 {
-  tex << "\\setbox\\ASYbox=\\hbox{" << stripblanklines(s) << "}\n\n";
-  tex.wait(texready.c_str());
-  texdim(tex,width,"wd","width");
-  texdim(tex,height,"ht","height");
-  texdim(tex,depth,"dp","depth");
+  string r;
+  for(size_t i=0; i < s.size(); ++i) {
+    if(s[i] == '\\' && i+1 < s.size()) {
+      ++i;
+      r += (s[i] == 'n') ? '\n' : s[i];
+    } else r += s[i];
+  }
+  return r;
 }
 
-inline double urand()
+void loadlabelcache()
 {
-  static const double factor=2.0/RANDOM_MAX;
-  return random()*factor-1.0;
+  labeldimsLoaded=true;
+  if(!getSetting<bool>("labelcache")) return;
+  std::ifstream fin(labelcachename().c_str());
+  string line;
+  while(getline(fin,line)) {
+    istringstream in(line);
+    labeldims d;
+    string key;
+    if(in >> d.width >> d.height >> d.depth && in.get() == ' ' &&
+       getline(in,key))
+      labeldimsCache[unescapekey(key)]=d;
+  }
 }
 
-void setpen(iopipestream& tex, const string& texengine, const pen& pentype)
+void storelabeldims(const mem::vector<string>& keys,
+                    const mem::vector<labeldims>& dims)
 {
-  bool Latex=latex(texengine);
+  for(size_t i=0; i < keys.size(); ++i)
+    labeldimsCache[keys[i]]=dims[i];
+  if(!getSetting<bool>("labelcache")) return;
+  if(mkdir(initdir.c_str(),0777) != 0 && errno != EEXIST) return;
+  std::ofstream fout(labelcachename().c_str(),std::ios::app);
+  fout << std::setprecision(17);
+  for(size_t i=0; i < keys.size(); ++i)
+    fout << dims[i].width << " " << dims[i].height << " " << dims[i].depth
+         << " " << escapekey(keys[i]) << "\n";
+}
 
-  if(Latex && setlatexfont(tex,pentype,drawElement::lastpen)) {
-    tex << "\n";
-    tex.wait(texready.c_str());
-  }
-  if(settexfont(tex,pentype,drawElement::lastpen,Latex)) {
-    tex << "\n";
-    tex.wait(texready.c_str());
+const unsigned long long fnvoffset=14695981039346656037ULL;
+
+// Adds line s to the FNV-1a hash h.
+void fnvhash(unsigned long long& h, const string& s)
+{
+  for(size_t i=0; i < s.size(); ++i) {
+    h ^= (unsigned char) s[i];
+    h *= 1099511628211ULL;
   }
+  h ^= '\n';
+  h *= 1099511628211ULL;
+}
+
+// Hash of the verbatim TeX code sent to the running TeX process, which may
+// redefine macros used in the labels measured after it.
+unsigned long long texstate=fnvoffset;
+
+void texstatereset()
+{
+  texstate=fnvoffset;
+}
+
+void texstatechange(const string& s)
+{
+  fnvhash(texstate,s);
+}
+
+// Hash of the TeX preamble, which determines the meaning of the macros used
+// in labels, and of the verbatim TeX code sent so far.
+string preamblehash()
+{
+  unsigned long long h=fnvoffset;
+  mem::list<string>& preamble=processData().TeXpreamble;
+  for(mem::list<string>::iterator p=preamble.begin(); p != preamble.end();
+      ++p)
+    fnvhash(h,*p);
+  ostringstream buf;
+  buf << std::hex << h << " " << texstate;
+  return buf.str();
+}
+
+// Identifies the dimensions of label s typeset in pen p.
+string labelkey(const string& texengine, const pen& p, const string& s)
+{
+  ostringstream buf;
+  buf << std::setprecision(17) << texengine << " " << texcommand() << " "
+      << preamblehash() << "\n" << p.Font() << "\n" << p.size() << " "
+      << p.Lineskip() << "\n" << s;
+  return buf.str();
+}
+
+bool lookuplabeldims(const string& key, double& width, double& height,
+                     double& depth)
+{
+  if(!labeldimsLoaded) loadlabelcache();
+  labeldimsMap::iterator p=labeldimsCache.find(key);
+  if(p == labeldimsCache.end()) return false;
+  width=p->second.width;
+  height=p->second.height;
+  depth=p->second.depth;
+  return true;
+}
+
+// Writes the commands that select the font of pen p, unless it is already
+// active.  The responses of TeX are read along with the next label dimensions.
+void setpen(ostream& out, const string& texengine, const pen& pentype)
+{
+  bool Latex=latex(texengine);
+
+  if(Latex && setlatexfont(out,pentype,drawElement::lastpen))
+    out << "\n";
+  if(settexfont(out,pentype,drawElement::lastpen,Latex))
+    out << "\n";
 
   drawElement::lastpen=pentype;
 }
 
+// Asks TeX for all dimensions of label s on one line, tagged with number n.
+void texrequest(ostream& out, const string& s, size_t n)
+{
+  out << "\\setbox\\ASYbox=\\hbox{" << stripblanklines(s) << "}\n\n"
+      << "\\immediate\\write16{>dim(" << n << ":\\the\\wd\\ASYbox,"
+      << "\\the\\ht\\ASYbox,\\the\\dp\\ASYbox)dim}\n";
+}
+
+// Reads the answers to the requests 0,...,n-1 from the pipe.  Since TeX
+// prompts for each line it reads, the end of the output is marked
+// explicitly.
+void texresponse(iopipestream& tex, mem::vector<labeldims>& dims, size_t n)
+{
+  tex << "\\immediate\\write16{>dims)end}\n";
+  tex.wait(">dims)end\n\n*");
+  string buffer=tex.getbuffer();
+  dims.resize(n);
+  size_t pos=0;
+  string cannotread="Cannot read label dimensions";
+  for(size_t i=0; i < n; ++i) {
+    ostringstream start;
+    start << ">dim(" << i << ":";
+    size_t dim1=buffer.find(start.str(),pos);
+    size_t dim2=dim1 == string::npos ? dim1 : buffer.find(")dim",dim1);
+    if(dim2 == string::npos)
+      camp::reportError(cannotread);
+    istringstream in(buffer.substr(dim1+start.str().size(),
+                                   dim2-dim1-start.str().size()));
+    double d[3];
+    string unit;
+    for(size_t j=0; j < 3; ++j) {
+      if(!(in >> d[j]) || !getline(in,unit,',') || unit != "pt")
+        camp::reportError(cannotread);
+    }
+    dims[i].width=d[0]*tex2ps;
+    dims[i].height=d[1]*tex2ps;
+    dims[i].depth=d[2]*tex2ps;
+    pos=dim2;
+  }
+}
+
+void texbounds(double& width, double& height, double& depth,
+               iopipestream& tex, const string& texengine, const pen& pentype,
+               const string& s)
+{
+  string key=labelkey(texengine,pentype,s);
+  if(lookuplabeldims(key,width,height,depth)) return;
+
+  ostringstream out;
+  setpen(out,texengine,pentype);
+  texrequest(out,s,0);
+  tex << out.str();
+
+  mem::vector<labeldims> dims;
+  texresponse(tex,dims,1);
+  storelabeldims(mem::vector<string>(1,key),dims);
+  width=dims[0].width;
+  height=dims[0].height;
+  depth=dims[0].depth;
+}
+
+void texbatch::add(const pen& pentype, const string& s)
+{
+  string key=labelkey(texengine,pentype,s);
+  double width,height,depth;
+  if(lookuplabeldims(key,width,height,depth) ||
+     !queued.insert(std::make_pair(key,keys.size())).second)
+    return;
+
+  ostringstream out;
+  setpen(out,texengine,pentype);
+  texrequest(out,s,keys.size());
+  keys.push_back(key);
+  tex << out.str();
+
+  // Keep the requests well below the pipe capacity, since TeX stops reading
+  // them once its own output fills the other pipe.
+  written += out.str().size();
+  if(written > 16384) flush();
+}
+
+void texbatch::flush()
+{
+  if(keys.empty()) return;
+  mem::vector<labeldims> dims;
+  texresponse(tex,dims,keys.size());
+  storelabeldims(keys,dims);
+  keys.clear();
+  queued.clear();
+  written=0;
+}
+
+inline double urand()
+{
+  static const double factor=2.0/RANDOM_MAX;
+  return random()*factor-1.0;
+}
+
 void drawLabel::getbounds(iopipestream& tex, const string& texengine)
 {
   if(havebounds) return;
   havebounds=true;
 
-  setpen(tex,texengine,pentype);
-  texbounds(width,height,depth,tex,label);
+  texbounds(width,height,depth,tex,texengine,pentype,label);
 
   if(width == 0.0 && height == 0.0 && depth == 0.0 && !size.empty())
-    texbounds(width,height,depth,tex,size);
+    texbounds(width,height,depth,tex,texengine,pentype,size);
 
   enabled=true;
 
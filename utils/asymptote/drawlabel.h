@@ -15,6 +15,22 @@
 
 namespace camp {
 
+// Measures several labels with one round trip to TeX: the requests are sent
+// without waiting, and the answers are read (and cached) by flush().
+class texbatch {
+  iopipestream& tex;
+  string texengine;
+  mem::vector<string> keys;
+  mem::map<CONST string,size_t> queued;
+  size_t written;
+public:
+  texbatch(iopipestream& tex, const string& texengine)
+    : tex(tex), texengine(texengine), written(0) {}
+
+  void add(const pen& pentype, const string& s);
+  void flush();
+};
+
 class drawLabel : public virtual drawElement {
 protected:
   string label,size;
@@ -43,6 +59,11 @@ public:
 
   void getbounds(iopipestream& tex, const string& texengine);
 
+  // Request the dimensions of the label in advance (see picture::bounds).
+  void queuebounds(texbatch& batch) {
+    if(!havebounds) batch.add(pentype,label);
+  }
+
   void checkbounds();
 
   void bounds(bbox& b, iopipestream&, boxvector&, bboxlist&);
@@ -81,9 +102,15 @@ public:
   drawElement *transformed(const transform& t);
 };
 
-void setpen(iopipestream& tex, const string& texengine, const pen& pentype);
+// Verbatim TeX code sent to the TeX pipe outside of labels is part of the
+// key under which label dimensions are cached; a new TeX process starts
+// with an empty state.
+void texstatechange(const string& s);
+void texstatereset();
+
 void texbounds(double& width, double& height, double& depth,
-               iopipestream& tex, string& s);
+               iopipestream& tex, const string& texengine, const pen& pentype,
+               const string& s);
 
 }
 
@@ -32,7 +32,7 @@ public:
     return lineNum;
   }
 
-  string name() const {
+  const string& name() const {
     return filename;
   }
 
@@ -100,7 +100,7 @@ public:
     return std::pair<size_t,size_t>(line,column);
   }
 
-  bool match(const string& s) {
+  bool match(const string& s) const {
     return file && file->name() == s;
   }
 
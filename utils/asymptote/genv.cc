@@ -15,6 +15,7 @@
 
 #include <sstream>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <algorithm>
 
 #include "genv.h"
@@ -38,9 +39,71 @@ types::record *transExternalModule(trans::genv& ge, string filename, symbol id);
 
 namespace trans {
 
+namespace {
+// Translated modules are shared by all global environments of the process,
+// so that processing several files in one run (or resetting an interactive
+// session) translates plain, graph, three, etc. only once.  The translated
+// record and its initializer do not depend on the global environment that
+// requested them; only the run-time instances (see vm::stack::load) do.
+struct sourceStamp {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+
+  bool operator== (const sourceStamp& s) const {
+    return dev == s.dev && ino == s.ino && size == s.size && mtime == s.mtime;
+  }
+};
+
+bool getStamp(const string& file, sourceStamp& stamp)
+{
+  struct stat buf;
+  if(stat(file.c_str(),&buf) != 0)
+    return false;
+  stamp.dev=buf.st_dev;
+  stamp.ino=buf.st_ino;
+  stamp.size=buf.st_size;
+  stamp.mtime=buf.st_mtime;
+  return true;
+}
+
+struct cachedModule : public gc {
+  record *r;
+  string file;
+  sourceStamp stamp;
+  mem::list<string> imports;
+
+  cachedModule(record *r, const string& file, const sourceStamp& stamp,
+               const mem::list<string>& imports)
+    : r(r), file(file), stamp(stamp), imports(imports) {}
+};
+
+// Indexed by the located source file (and the autoplain setting it was
+// translated with).
+typedef mem::map<CONST string,cachedModule *> moduleCache;
+moduleCache modules;
+
+// A cached module may refer to the records of the modules it imports, so
+// if any source file has changed (or a relative path now refers to another
+// file), the whole cache is dropped rather than just the modified entry.
+void validateModuleCache()
+{
+  for(moduleCache::iterator p=modules.begin(); p != modules.end(); ++p) {
+    sourceStamp stamp;
+    if(!getStamp(p->second->file,stamp) || !(stamp == p->second->stamp)) {
+      modules.clear();
+      return;
+    }
+  }
+}
+}
+
 genv::genv()
   : imap()
 {
+  validateModuleCache();
+
   // Add settings as a module.  This is so that the init file ~/.asy/config.asy
   // can set settings.
   imap["settings"]=settings::getSettingsModule();
@@ -86,6 +149,41 @@ record *genv::loadModule(symbol id, string filename) {
   return r;
 }
 
+record *genv::getCachedModule(symbol id, string filename) {
+#ifdef HAVE_LIBCURL
+  if(parser::isURL(filename))
+    return loadModule(id, filename);
+#endif
+  string file=settings::locateFile(filename);
+  sourceStamp stamp;
+  if(file.empty() || !getStamp(file,stamp))
+    return loadModule(id, filename); // Let the parser report the error.
+
+  string key=(getSetting<bool>("autoplain") ? "+" : "-")+file;
+  moduleCache::iterator p=modules.find(key);
+  if(p != modules.end() && p->second->stamp == stamp) {
+    // The initializer loads the imported modules through imap at runtime.
+    cachedModule *m=p->second;
+    for(mem::list<string>::iterator i=m->imports.begin();
+        i != m->imports.end(); ++i)
+      getModule(symbol::trans(*i), *i);
+    return m->r;
+  }
+
+  importsInTranslation.push_back(mem::list<string>());
+  record *r;
+  try {
+    r=loadModule(id, filename);
+  } catch(...) {
+    importsInTranslation.pop_back();
+    throw;
+  }
+  if(!em.errors())
+    modules[key]=new cachedModule(r,file,stamp,importsInTranslation.back());
+  importsInTranslation.pop_back();
+  return r;
+}
+
 void genv::checkRecursion(string filename) {
   if (find(inTranslation.begin(), inTranslation.end(), filename) !=
       inTranslation.end()) {
@@ -99,11 +197,14 @@ void genv::checkRecursion(string filename) {
 record *genv::getModule(symbol id, string filename) {
   checkRecursion(filename);
 
+  if(!importsInTranslation.empty())
+    importsInTranslation.back().push_back(filename);
+
   record *r=imap[filename];
   if (r)
     return r;
   else {
-    record *r=loadModule(id, filename);
+    record *r=getCachedModule(id, filename);
     // Don't add an erroneous module to the dictionary in interactive mode, as
     // the user may try to load it again.
     if (!interact::interactive || !em.errors())
@@ -38,6 +38,11 @@ class genv : public gc {
   // recursion in loading modules.
   mem::list<string> inTranslation;
 
+  // For each module in translation, the modules it imports.  These are
+  // stored with the translated module, so they can be added to imap when
+  // the module is taken from the cache.
+  mem::list<mem::list<string> > importsInTranslation;
+
   // Checks for recursion in loading, reporting an error and throwing an
   // exception if it occurs.
   void checkRecursion(string filename);
@@ -45,6 +50,10 @@ class genv : public gc {
   // Translate a module to build the record type.
   record *loadModule(symbol name, string s);
 
+  // Look up a module translated by an earlier genv of this process, or
+  // translate it and remember the result.
+  record *getCachedModule(symbol name, string s);
+
 public:
   genv();
 
@@ -38,6 +38,14 @@ OPCODE(popframe,'x')
 OPCODE(push_default,'x')
 OPCODE(jump_if_not_default,'o')
 
+/* Superinstructions, formed by program::encode from the listed opcode and
+ * the one that follows it. */
+OPCODE(varsave_pop,'n')
+OPCODE(fieldsave_pop,'n')
+OPCODE(varpush_fieldpush,'n')
+OPCODE(builtin_cjmp,'b')
+OPCODE(builtin_njmp,'b')
+
 #ifdef COMBO
 OPCODE(varpop,'n')
 OPCODE(fieldpop,'n')
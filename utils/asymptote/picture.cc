@@ -274,24 +274,44 @@ bbox picture::bounds()
     bboxstack.clear();
   }
 
-  if(havelabels()) texinit();
-
   nodelist::iterator p=nodes.begin();
   processDataStruct& pd=processData();
 
   for(size_t i=0; i < lastnumber; ++i) ++p;
-  for(; p != nodes.end(); ++p) {
-    assert(*p);
-    (*p)->bounds(b_cached,pd.tex,labelbounds,bboxstack);
-
-    // Optimization for interpreters with fixed stack limits.
-    if((*p)->endclip()) {
-      nodelist::iterator q=p;
-      if(q != nodes.begin()) {
-        --q;
-        assert(*q);
-        if((*q)->endclip())
-          (*q)->save(false);
+
+  bool labels=havelabels();
+  if(labels) texinit();
+
+  while(p != nodes.end()) {
+    nodelist::iterator end=nodes.end();
+    if(labels) {
+      // Measure the new labels in batches rather than one at a time.  A batch
+      // ends after verbatim TeX code, which may affect the labels after it.
+      texbatch batch(pd.tex,getSetting<string>("tex"));
+      for(end=p; end != nodes.end();) {
+        assert(*end);
+        drawElement *e=*end++;
+        if(drawLabel *L=dynamic_cast<drawLabel *>(e))
+          L->queuebounds(batch);
+        else if(e->islabel() && dynamic_cast<drawVerbatim *>(e))
+          break;
+      }
+      batch.flush();
+    }
+
+    for(; p != end; ++p) {
+      assert(*p);
+      (*p)->bounds(b_cached,pd.tex,labelbounds,bboxstack);
+
+      // Optimization for interpreters with fixed stack limits.
+      if((*p)->endclip()) {
+        nodelist::iterator q=p;
+        if(q != nodes.begin()) {
+          --q;
+          assert(*q);
+          if((*q)->endclip())
+            (*q)->save(false);
+        }
       }
     }
   }
@@ -394,6 +414,7 @@ void texinit()
   }
 
   pd.tex.open(cmd,"texpath");
+  texstatereset();
   pd.tex.wait("\n*");
   pd.tex << "\n";
   texdocumentclass(pd.tex,true);
@@ -26,6 +26,38 @@ static const char optypes[] = {
 #undef OPCODE
 };
 
+void program::encode(inst i)
+{
+  // Fuse common pairs of instructions into a single superinstruction, saving
+  // a dispatch in the stack machine.  The second instruction is still
+  // encoded, so that jumps to it and later patching remain valid; the fused
+  // instruction skips over it when run.
+  if (!code.empty()) {
+    inst& last = code.back();
+    switch (i.op) {
+      case inst::pop:
+        if (last.op == inst::varsave)
+          last.op = inst::varsave_pop;
+        else if (last.op == inst::fieldsave)
+          last.op = inst::fieldsave_pop;
+        break;
+      case inst::fieldpush:
+        if (last.op == inst::varpush)
+          last.op = inst::varpush_fieldpush;
+        break;
+      case inst::cjmp:
+      case inst::njmp:
+        if (last.op == inst::builtin)
+          last.op = i.op == inst::cjmp ? inst::builtin_cjmp :
+            inst::builtin_njmp;
+        break;
+      default:
+        break;
+    }
+  }
+  code.push_back(i);
+}
+
 #ifdef DEBUG_BLTIN
 mem::map<bltin,string> bltinRegistry;
 
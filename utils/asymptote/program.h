@@ -74,8 +74,6 @@ inline inst& program::back()
 { return code.back(); }
 inline void program::pop_back()
 { return code.pop_back(); }
-inline void program::encode(inst i)
-{ code.push_back(i); }
 inline inst& program::operator[](size_t n)
 { return code[n]; }
 inline program::label& program::label::operator++()
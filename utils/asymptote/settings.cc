@@ -1274,6 +1274,8 @@ void initSettings() {
 
   addOption(new boolSetting("twice", 0,
                             "Run LaTeX twice (to resolve references)"));
+  addOption(new boolSetting("labelcache", 0,
+                            "Reuse label dimensions measured in earlier runs"));
   addOption(new boolSetting("inlinetex", 0, "Generate inline TeX code"));
   addOption(new boolSetting("embed", 0, "Embed rendered preview image", true));
   addOption(new boolSetting("auto3D", 0, "Automatically activate 3D scene",
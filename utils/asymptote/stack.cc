@@ -15,6 +15,7 @@
 #include "util.h"
 #include "runtime.h"
 #include "process.h"
+#include "builtin.h"
 
 #include "profiler.h"
 
@@ -339,48 +340,85 @@ void stack::runWithOrWithoutClosure(lambda *l, vars_t vars, vars_t parent)
   position& topPos=processData().topPos;
   string& fileName=processData().fileName;
 
-  try {
-    for (;;) {
-      const inst &i = *ip;
-      curPos = i.pos;
-
-      if(curPos.filename() == fileName)
-        topPos=curPos;
+  // Work done before each instruction: track the position for error messages
+  // and the debugger, and honour interrupts.
+#define VM_PROLOGUE                                                     \
+  curPos = i->pos;                                                      \
+  if(curPos.match(fileName))                                            \
+    topPos=curPos;                                                      \
+  VM_PROFILE                                                            \
+  VM_TRACE                                                              \
+  if(settings::verbose > 4) em.trace(curPos);                           \
+  if(!bplist.empty()) debug();                                          \
+  if(errorstream::interrupt) throw interrupted();
 
 #ifdef PROFILE
-      prof.recordInstruction();
+#  define VM_PROFILE prof.recordInstruction();
+#else
+#  define VM_PROFILE
 #endif
 
 #ifdef DEBUG_STACK
-      printInst(cout, ip, l->code->begin());
-      cout << "    (";
-      i.pos.printTerse(cout);
-      cout << ")\n";
+#  define VM_TRACE                                                      \
+  printInst(cout, ip, l->code->begin());                                \
+  cout << "    (";                                                      \
+  i->pos.printTerse(cout);                                              \
+  cout << ")\n";
+#else
+#  define VM_TRACE
 #endif
 
-      if(settings::verbose > 4) em.trace(curPos);
-
-      if(!bplist.empty()) debug();
+  // With GCC-compatible compilers, each instruction jumps directly to the
+  // handler of the next one through a table of label addresses, which gives
+  // every handler its own indirect branch to predict.  Otherwise, fall back
+  // to a switch statement in a loop.
+#if defined(__GNUC__) && !defined(DEBUG_STACK)
+#  define VM_THREADED
+#  define VM_CASE(name) op_##name
+#  define VM_DISPATCH { i = &*ip; VM_PROLOGUE goto *dispatch[i->op]; }
+#  define VM_NEXT { ++ip; VM_DISPATCH }
+#  define VM_JUMP(target) { ip = (target); VM_DISPATCH }
+#else
+#  define VM_CASE(name) case inst::name
+#  define VM_NEXT break
+#  define VM_JUMP(target) { ip = (target); continue; }
+#endif
 
-      if(errorstream::interrupt) throw interrupted();
+  try {
+#ifdef VM_THREADED
+    static const void *dispatch[] = {
+#define OPCODE(name, type) &&op_##name,
+#include "opcodes.h"
+#undef OPCODE
+    };
+
+    const inst *i;
+    VM_DISPATCH;
+    {
+      {
+#else
+    for (;;) {
+      const inst *i = &*ip;
+      VM_PROLOGUE;
 
-      switch (i.op)
+      switch (i->op)
         {
-          case inst::varpush:
-            push(VAR(get<Int>(i)));
-            break;
+#endif
+          VM_CASE(varpush):
+            push(VAR(get<Int>(*i)));
+            VM_NEXT;
 
-          case inst::varsave:
-            VAR(get<Int>(i)) = top();
-            break;
+          VM_CASE(varsave):
+            VAR(get<Int>(*i)) = top();
+            VM_NEXT;
 
 #ifdef COMBO
-          case inst::varpop:
-            VAR(get<Int>(i)) = pop();
-            break;
+          VM_CASE(varpop):
+            VAR(get<Int>(*i)) = pop();
+            VM_NEXT;
 #endif
 
-          case inst::ret: {
+          VM_CASE(ret): {
             if (vars == 0)
               // Delete the frame from the stack.
               // TODO: Optimize for common cases.
@@ -389,74 +427,74 @@ void stack::runWithOrWithoutClosure(lambda *l, vars_t vars, vars_t parent)
             return;
           }
 
-          case inst::pushframe:
+          VM_CASE(pushframe):
           {
             assert(vars);
-            Int size = get<Int>(i);
+            Int size = get<Int>(*i);
             vars=make_pushframe(size, vars);
 
             SET_VARLINK;
 
-            break;
+            VM_NEXT;
           }
 
-          case inst::popframe:
+          VM_CASE(popframe):
           {
             assert(vars);
             vars=get<frame *>(VAR(0));
 
             SET_VARLINK;
 
-            break;
+            VM_NEXT;
           }
 
-          case inst::pushclosure:
+          VM_CASE(pushclosure):
             assert(vars);
             push(vars);
-            break;
+            VM_NEXT;
 
-          case inst::nop:
-            break;
+          VM_CASE(nop):
+            VM_NEXT;
 
-          case inst::pop:
+          VM_CASE(pop):
             pop();
-            break;
+            VM_NEXT;
 
-          case inst::intpush:
-          case inst::constpush:
-            push(i.ref);
-            break;
+          VM_CASE(intpush):
+          VM_CASE(constpush):
+            push(i->ref);
+            VM_NEXT;
 
-          case inst::fieldpush: {
+          VM_CASE(fieldpush): {
             vars_t frame = pop<vars_t>();
             if (!frame)
               error(dereferenceNullPointer);
-            push(FRAMEVAR(frame, get<Int>(i)));
-            break;
+            push(FRAMEVAR(frame, get<Int>(*i)));
+            VM_NEXT;
           }
 
-          case inst::fieldsave: {
+          VM_CASE(fieldsave): {
             vars_t frame = pop<vars_t>();
             if (!frame)
               error(dereferenceNullPointer);
-            FRAMEVAR(frame, get<Int>(i)) = top();
-            break;
+            FRAMEVAR(frame, get<Int>(*i)) = top();
+            VM_NEXT;
           }
 
 #if COMBO
-          case inst::fieldpop: {
+          VM_CASE(fieldpop): {
 #error NOT REIMPLEMENTED
             vars_t frame = pop<vars_t>();
             if (!frame)
               error(dereferenceNullPointer);
-            FRAMEVAR(get<Int>(i)) = pop();
-            break;
+            FRAMEVAR(get<Int>(*i)) = pop();
+            VM_NEXT;
           }
 #endif
 
 
-          case inst::builtin: {
-            bltin func = get<bltin>(i);
+          VM_CASE(builtin): {
+            bltin func = get<bltin>(*i);
 #ifdef PROFILE
             prof.beginFunction(func);
 #endif
@@ -464,75 +502,127 @@ void stack::runWithOrWithoutClosure(lambda *l, vars_t vars, vars_t parent)
 #ifdef PROFILE
             prof.endFunction(func);
 #endif
-            break;
+            VM_NEXT;
           }
 
-          case inst::jmp:
-            ip = get<program::label>(i);
-            continue;
+          VM_CASE(jmp):
+            VM_JUMP(get<program::label>(*i));
+
+          VM_CASE(cjmp):
+            if (pop<bool>()) VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
+
+          VM_CASE(njmp):
+            if (!pop<bool>()) VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
+
+          VM_CASE(jump_if_not_default):
+            if (!isdefault(pop())) VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
 
-          case inst::cjmp:
-            if (pop<bool>()) { ip = get<program::label>(i); continue; }
-            break;
+          // Superinstructions formed by program::encode.  Each one performs
+          // its own instruction and the one following it, then skips over
+          // the latter, which is left in place as a possible jump target.
+          VM_CASE(varsave_pop):
+            VAR(get<Int>(*i)) = pop();
+            ++ip;
+            VM_NEXT;
 
-          case inst::njmp:
-            if (!pop<bool>()) { ip = get<program::label>(i); continue; }
-            break;
+          VM_CASE(fieldsave_pop): {
+            vars_t frame = pop<vars_t>();
+            if (!frame)
+              error(dereferenceNullPointer);
+            FRAMEVAR(frame, get<Int>(*i)) = pop();
+            ++ip;
+            VM_NEXT;
+          }
+
+          VM_CASE(varpush_fieldpush): {
+            vars_t frame = get<vars_t>(VAR(get<Int>(*i)));
+            ++ip;
+            if (!frame)
+              error(dereferenceNullPointer);
+            push(FRAMEVAR(frame, get<Int>(*ip)));
+            VM_NEXT;
+          }
 
-          case inst::jump_if_not_default:
-            if (!isdefault(pop())) { ip = get<program::label>(i); continue; }
-            break;
+          VM_CASE(builtin_cjmp):
+          VM_CASE(builtin_njmp): {
+            bltin func = get<bltin>(*i);
+            bool cond;
+            // Compare unboxed integers directly for the common loop tests.
+            if (func == run::intLess || func == run::intGreater) {
+              Int y = pop<Int>();
+              Int x = pop<Int>();
+              cond = func == run::intLess ? x < y : x > y;
+            } else {
+#ifdef PROFILE
+              prof.beginFunction(func);
+#endif
+              func(this);
+#ifdef PROFILE
+              prof.endFunction(func);
+#endif
+              cond = pop<bool>();
+            }
+            ++ip;
+            if (cond == (i->op == inst::builtin_cjmp))
+              VM_JUMP(get<program::label>(*ip));
+            VM_NEXT;
+          }
 
 #ifdef COMBO
-          case inst::gejmp: {
+          VM_CASE(gejmp): {
             Int y = pop<Int>();
             Int x = pop<Int>();
             if (x>=y)
-              { ip = get<program::label>(i); continue; }
-            break;
+              VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
           }
 
 #if 0
-          case inst::jump_if_func_eq: {
+          VM_CASE(jump_if_func_eq): {
             callable * b=pop<callable *>();
             callable * a=pop<callable *>();
             if (a->compare(b))
-              { ip = get<program::label>(i); continue; }
-            break;
+              VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
           }
 
-          case inst::jump_if_func_neq: {
+          VM_CASE(jump_if_func_neq): {
             callable * b=pop<callable *>();
             callable * a=pop<callable *>();
             if (!a->compare(b))
-              { ip = get<program::label>(i); continue; }
-            break;
+              VM_JUMP(get<program::label>(*i));
+            VM_NEXT;
           }
 #endif
 #endif
 
-          case inst::push_default:
+          VM_CASE(push_default):
             push(Default);
-            break;
+            VM_NEXT;
 
-          case inst::popcall: {
+          VM_CASE(popcall): {
             /* get the function reference off of the stack */
             callable* f = pop<callable*>();
             f->call(this);
-            break;
+            VM_NEXT;
           }
 
-          case inst::makefunc: {
+          VM_CASE(makefunc): {
             func *f = new func;
             f->closure = pop<vars_t>();
-            f->body = get<lambda*>(i);
+            f->body = get<lambda*>(*i);
 
             push((callable*)f);
-            break;
+            VM_NEXT;
           }
 
+#ifndef VM_THREADED
           default:
             error("Internal VM error: Bad stack operand");
+#endif
         }
 
 #ifdef DEBUG_STACK
@@ -541,12 +631,23 @@ void stack::runWithOrWithoutClosure(lambda *l, vars_t vars, vars_t parent)
       cerr << "\n";
 #endif
 
+#ifndef VM_THREADED
       ++ip;
+#endif
     }
   } catch (bad_item_value&) {
     error("Trying to use uninitialized value.");
   }
 
+#undef VM_PROLOGUE
+#undef VM_PROFILE
+#undef VM_TRACE
+#undef VM_THREADED
+#undef VM_CASE
+#undef VM_DISPATCH
+#undef VM_NEXT
+#undef VM_JUMP
+
 #undef SET_VARLINK
 #undef VAR
 #undef FRAMEVAR